@@ -0,0 +1,273 @@
+#include "BoundsCheckElimination.hpp"
+#include <algorithm>
+
+void GobLang::Compiler::BoundsCheckElimination::optimize()
+{
+    if (!m_code.decode(m_byteCode))
+    {
+        return;
+    }
+    std::vector<CodeRegion> regions = m_code.getCodeRegions(m_byteCode);
+    std::vector<Instruction> const &instructions = m_code.getInstructions();
+    std::vector<bool> isJumpTarget = m_code.getJumpTargets();
+    // operations are only replaced with operations of the same size, so indices of instructions never change
+    bool changed = false;
+    for (std::vector<CodeRegion>::const_iterator it = regions.begin(); it != regions.end(); it++)
+    {
+        size_t start = it->start;
+        size_t end = m_code.getCodeEnd(start);
+        ControlFlowGraph graph;
+        if (!graph.build(m_code, start, it->argCount))
+        {
+            continue;
+        }
+        std::vector<FrameState> const &states = graph.getStates();
+        // every loop ends with a jump back to the condition
+        for (size_t i = start; i < end; i++)
+        {
+            Instruction const &instr = instructions[i];
+            if (instr.op != Operation::Jump || instr.target < start || instr.target >= i)
+            {
+                continue;
+            }
+            if (!states[instr.target - start].isReachable || !states[i - start].isReachable)
+            {
+                continue;
+            }
+            changed |= _optimizeLoop(graph, instr.target, i, isJumpTarget);
+        }
+    }
+    if (changed)
+    {
+        m_code.encode(m_byteCode);
+    }
+}
+
+bool GobLang::Compiler::BoundsCheckElimination::_optimizeLoop(ControlFlowGraph const &graph, size_t header, size_t back, std::vector<bool> const &isJumpTarget)
+{
+    std::vector<Instruction> &instructions = m_code.getInstructions();
+    size_t localCount = graph.getStates()[header - graph.getStart()].localCount;
+    size_t exit = back + 1;
+    if (header + 4 >= back)
+    {
+        return false;
+    }
+    // condition must start with `i < sizeof(a)`
+    Instruction const &index = instructions[header];
+    Instruction const &array = instructions[header + 1];
+    Instruction const &size = instructions[header + 2];
+    Instruction const &compare = instructions[header + 3];
+    if (index.op != Operation::GetLocal || array.op != Operation::GetLocal || size.op != Operation::CallNative ||
+        (compare.op != Operation::Less && compare.op != Operation::LessInt))
+    {
+        return false;
+    }
+    uint8_t indexId = index.args[0];
+    uint8_t arrayId = array.args[0];
+    if (indexId == arrayId || indexId >= localCount || arrayId >= localCount)
+    {
+        return false;
+    }
+    if (size.args[1] != 1 || size.args[0] >= m_byteCode.natives.size() ||
+        m_byteCode.natives[size.args[0]] != "sizeof" || m_byteCode.nativeEffects[size.args[0]] != NativeFunctionEffect::Pure)
+    {
+        return false;
+    }
+    // comparison is either the whole condition or the left side of `&&`, which jumps to the final check when it fails
+    Instruction const &check = instructions[header + 4];
+    size_t condEnd = header + 4;
+    if (check.op == Operation::JumpIfNotOrPop && check.target > condEnd && check.target < back &&
+        instructions[check.target].op == Operation::JumpIfNot)
+    {
+        condEnd = check.target;
+    }
+    else if (check.op != Operation::JumpIfNot)
+    {
+        return false;
+    }
+    if (instructions[condEnd].target != exit)
+    {
+        return false;
+    }
+
+    // loop must be entered only through the condition and the rest of the condition can only be reached after the comparison
+    for (size_t i = 0; i < instructions.size(); i++)
+    {
+        Instruction const &instr = instructions[i];
+        if (!instr.hasTarget)
+        {
+            continue;
+        }
+        bool isInside = i >= header && i <= back;
+        if (!isInside && instr.target >= header && instr.target <= back)
+        {
+            return false;
+        }
+        bool isCondition = i > header + 3 && i < condEnd;
+        if (isCondition != (instr.target > header && instr.target <= condEnd))
+        {
+            return false;
+        }
+    }
+
+    // index can only be changed by a single increase and array can't be changed at all
+    size_t incIndex = SIZE_MAX;
+    for (size_t i = header; i <= back; i++)
+    {
+        Instruction const &instr = instructions[i];
+        switch (getInstructionEffect(instr, m_byteCode))
+        {
+        case InstructionEffect::WritesLocal:
+        {
+            if (instr.args[0] == arrayId || (instr.args[0] == indexId && instr.op != Operation::IncrementLocal))
+            {
+                return false;
+            }
+            if (instr.args[0] != indexId)
+            {
+                break;
+            }
+            uint32_t rawDelta = 0;
+            for (size_t j = 1; j < instr.args.size(); j++)
+            {
+                rawDelta = (rawDelta << 8) | instr.args[j];
+            }
+            if (incIndex != SIZE_MAX || (int32_t)rawDelta <= 0)
+            {
+                return false;
+            }
+            incIndex = i;
+        }
+        break;
+        case InstructionEffect::Unknown:
+            return false;
+        default:
+            break;
+        }
+    }
+    if (incIndex == SIZE_MAX || incIndex <= condEnd)
+    {
+        return false;
+    }
+    // code after the increase can't go back to the accesses without passing the condition
+    for (size_t i = incIndex; i <= back; i++)
+    {
+        if (instructions[i].hasTarget && instructions[i].target > header && instructions[i].target <= incIndex)
+        {
+            return false;
+        }
+    }
+    if (!_hasNonNegativeStart(graph, header, incIndex, indexId, isJumpTarget))
+    {
+        return false;
+    }
+
+    bool changed = false;
+    for (size_t i = condEnd + 1; i < incIndex; i++)
+    {
+        Instruction &instr = instructions[i];
+        switch (instr.op)
+        {
+        case Operation::GetArrayLocal:
+            if (instr.args[0] == arrayId && i - 1 > condEnd && !isJumpTarget[i] &&
+                instructions[i - 1].op == Operation::GetLocal && instructions[i - 1].args[0] == indexId)
+            {
+                instr.op = Operation::GetArrayLocalUnchecked;
+                changed = true;
+            }
+            break;
+        case Operation::GetArray:
+            if (i - 2 > condEnd && !isJumpTarget[i] && !isJumpTarget[i - 1] &&
+                instructions[i - 2].op == Operation::GetLocal && instructions[i - 2].args[0] == indexId &&
+                instructions[i - 1].op == Operation::GetLocal && instructions[i - 1].args[0] == arrayId)
+            {
+                instr.op = Operation::GetArrayUnchecked;
+                changed = true;
+            }
+            break;
+        case Operation::SetArray:
+        {
+            // index and array are pushed before the new value
+            size_t valueStart = 0;
+            if (!_findValueStart(condEnd + 3, i, valueStart))
+            {
+                break;
+            }
+            if (std::find(isJumpTarget.begin() + valueStart - 1, isJumpTarget.begin() + i + 1, true) != isJumpTarget.begin() + i + 1)
+            {
+                break;
+            }
+            if (instructions[valueStart - 2].op == Operation::GetLocal && instructions[valueStart - 2].args[0] == indexId &&
+                instructions[valueStart - 1].op == Operation::GetLocal && instructions[valueStart - 1].args[0] == arrayId)
+            {
+                instr.op = Operation::SetArrayUnchecked;
+                changed = true;
+            }
+        }
+        break;
+        default:
+            break;
+        }
+    }
+    return changed;
+}
+
+bool GobLang::Compiler::BoundsCheckElimination::_hasNonNegativeStart(ControlFlowGraph const &graph, size_t header, size_t increase, uint8_t id, std::vector<bool> const &isJumpTarget) const
+{
+    std::vector<Instruction> const &instructions = m_code.getInstructions();
+    std::set<size_t> definitions = graph.getReachingDefinitions(header, id);
+    for (std::set<size_t>::const_iterator it = definitions.begin(); it != definitions.end(); it++)
+    {
+        if (*it == increase)
+        {
+            continue;
+        }
+        if (*it == ControlFlowGraph::EntryDefinition || *it == graph.getStart() || isJumpTarget[*it])
+        {
+            return false;
+        }
+        Instruction const &instr = instructions[*it];
+        Instruction const &value = instructions[*it - 1];
+        if (instr.op != Operation::SetLocal || instr.args[0] != id || value.op != Operation::PushConstInt)
+        {
+            return false;
+        }
+        uint32_t rawValue = 0;
+        for (std::vector<uint8_t>::const_iterator argIt = value.args.begin(); argIt != value.args.end(); argIt++)
+        {
+            rawValue = (rawValue << 8) | *argIt;
+        }
+        if ((int32_t)rawValue < 0)
+        {
+            return false;
+        }
+    }
+    return !definitions.empty();
+}
+
+bool GobLang::Compiler::BoundsCheckElimination::_findValueStart(size_t limit, size_t end, size_t &valueStart) const
+{
+    std::vector<Instruction> const &instructions = m_code.getInstructions();
+    int32_t total = 0;
+    for (size_t i = end; i > limit; i--)
+    {
+        Instruction const &instr = instructions[i - 1];
+        int32_t effect = 0;
+        if (instr.op == Operation::CallNative)
+        {
+            effect = 1 - (int32_t)instr.args[1];
+        }
+        else if (instr.hasTarget || !getStackEffect(instr, effect))
+        {
+            return false;
+        }
+        // every operation pushes at most one value, so the first time the sum reaches one is the start of the value
+        total += effect;
+        if (total == 1)
+        {
+            valueStart = i - 1;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "ByteCode.hpp"
+#include "InstructionList.hpp"
+#include "ControlFlowGraph.hpp"
+namespace GobLang::Compiler
+{
+    /**
+     * @brief Pass that removes index checks from array accesses in counted loops.
+     * Loop must have condition `i < sizeof(a)`, start with non negative constant `i` and only increase `i` at the end of the body.
+     * Accesses `a[i]` that happen before the increase are replaced with operations that don't check the index
+     *
+     */
+    class BoundsCheckElimination
+    {
+    public:
+        explicit BoundsCheckElimination(ByteCode const &code) : m_byteCode(code) {}
+
+        /**
+         * @brief Remove index checks in all suitable loops and write the new code into the byte code
+         *
+         */
+        void optimize();
+
+        ByteCode getByteCode() const { return m_byteCode; }
+
+    private:
+        /**
+         * @brief Try removing index checks in a single loop
+         *
+         * @param graph Graph of the code that contains the loop
+         * @param header Index of the first instruction of the loop condition
+         * @param back Index of the jump back to the loop condition
+         * @param isJumpTarget For each instruction, true if any jump leads to it
+         * @return true Code was changed
+         */
+        bool _optimizeLoop(ControlFlowGraph const &graph, size_t header, size_t back, std::vector<bool> const &isJumpTarget);
+
+        /**
+         * @brief Check if every assignment of the local variable that reaches the loop, except for the increase, sets it to a non negative int constant
+         *
+         * @param graph Graph of the code that contains the loop
+         * @param header Index of the first instruction of the loop condition
+         * @param increase Index of the instruction that increases the variable at the end of the loop
+         * @param id Id of the local variable
+         */
+        bool _hasNonNegativeStart(ControlFlowGraph const &graph, size_t header, size_t increase, uint8_t id, std::vector<bool> const &isJumpTarget) const;
+
+        /**
+         * @brief Find the first instruction of the code that pushes a single value to the stack right before the given instruction
+         *
+         * @param limit Index of the first instruction that can be a part of the value
+         * @param end Index of the instruction that uses the value
+         * @param valueStart Where to write index of the first instruction of the value
+         * @return true Value was found and its code doesn't contain jumps
+         */
+        bool _findValueStart(size_t limit, size_t end, size_t &valueStart) const;
+
+        ByteCode m_byteCode;
+        InstructionList m_code;
+    };
+}
@@ -5,9 +5,47 @@
 #include "../execution/Function.hpp"
 namespace GobLang::Compiler
 {
+    /**
+     * @brief What optimizations can assume about the native function
+     *
+     */
+    enum class NativeFunctionEffect
+    {
+        /**
+         * @brief Function can change any value
+         *
+         */
+        Any,
+        /**
+         * @brief Function doesn't change any existing arrays, strings or variables, but can have other side effects like printing text or creating new objects
+         *
+         */
+        ReadOnly,
+        /**
+         * @brief Function has no side effects and its result only depends on values of the arguments and sizes of arrays and strings passed to it
+         *
+         */
+        Pure,
+    };
+
     struct ByteCode
     {
         std::vector<std::string> ids;
+        /**
+         * @brief Names of global variables used by the code. Index of the name is the slot used by global variable operations
+         *
+         */
+        std::vector<std::string> globals;
+        /**
+         * @brief Names of native functions called by the code. Index of the name is the id used by `CallNative`
+         *
+         */
+        std::vector<std::string> natives;
+        /**
+         * @brief Effects of native functions in the same order as `natives`
+         *
+         */
+        std::vector<NativeFunctionEffect> nativeEffects;
         std::vector<uint8_t> operations;
         std::vector<Function> functions;
     };
@@ -0,0 +1,275 @@
+#include "CommonSubexpressionElimination.hpp"
+#include <algorithm>
+
+void GobLang::Compiler::CommonSubexpressionElimination::optimize()
+{
+    if (!m_code.decode(m_byteCode))
+    {
+        return;
+    }
+    std::vector<CodeRegion> regions = m_code.getCodeRegions(m_byteCode);
+    // code is processed from the end, so changing instructions doesn't move code that wasn't processed yet
+    bool changed = false;
+    for (std::vector<CodeRegion>::const_reverse_iterator it = regions.rbegin(); it != regions.rend(); it++)
+    {
+        size_t start = it->start;
+        ControlFlowGraph graph;
+        if (!graph.build(m_code, start, it->argCount))
+        {
+            continue;
+        }
+        // graph is not valid after the code changes, but blocks before the changed one keep their positions
+        std::vector<BasicBlock> blocks = graph.getBlocks();
+        std::vector<FrameState> states = graph.getStates();
+        for (std::vector<BasicBlock>::const_reverse_iterator blockIt = blocks.rbegin(); blockIt != blocks.rend(); blockIt++)
+        {
+            if (blockIt->isReachable)
+            {
+                std::vector<FrameState> blockStates(states.begin() + (blockIt->start - start), states.begin() + (blockIt->end - start));
+                changed |= _optimizeBlock(blockIt->start, blockIt->end, blockStates);
+            }
+        }
+    }
+    if (changed)
+    {
+        m_code.encode(m_byteCode);
+    }
+}
+
+bool GobLang::Compiler::CommonSubexpressionElimination::_optimizeBlock(size_t start, size_t end, std::vector<FrameState> const &states)
+{
+    std::vector<Expression> expressions = _findExpressions(start, end);
+    if (expressions.empty())
+    {
+        return false;
+    }
+    std::vector<Instruction> const &instructions = m_code.getInstructions();
+    // new variables are placed after every variable used in the block, so declaring variables doesn't change them
+    size_t base = 0;
+    size_t lastEnd = 0;
+    for (size_t i = start; i < end; i++)
+    {
+        base = std::max(base, states[i - start].localCount);
+        std::vector<size_t> localArgs = getLocalArguments(instructions[i].op);
+        for (std::vector<size_t>::const_iterator it = localArgs.begin(); it != localArgs.end(); it++)
+        {
+            base = std::max(base, (size_t)instructions[i].args[*it] + 1);
+        }
+    }
+    for (std::vector<Expression>::const_iterator it = expressions.begin(); it != expressions.end(); it++)
+    {
+        lastEnd = std::max(lastEnd, it->repeats.back().second);
+    }
+    // local variable ids are stored as a single byte
+    if (base + expressions.size() > UINT8_MAX + 1 || lastEnd + 1 >= end)
+    {
+        return false;
+    }
+
+    struct Change
+    {
+        size_t index;
+        /**
+         * @brief Amount of instructions to replace or 0 if instruction is inserted
+         *
+         */
+        size_t count;
+        Instruction instr;
+    };
+    std::vector<Change> changes;
+    for (size_t i = 0; i < expressions.size(); i++)
+    {
+        uint8_t id = (uint8_t)(base + i);
+        changes.push_back(Change{.index = expressions[i].firstEnd + 1, .count = 0, .instr = Instruction{.op = Operation::SetLocalKeep, .args = {id}}});
+        for (std::vector<std::pair<size_t, size_t>>::const_iterator it = expressions[i].repeats.begin(); it != expressions[i].repeats.end(); it++)
+        {
+            changes.push_back(Change{.index = it->first, .count = it->second - it->first + 1, .instr = Instruction{.op = Operation::GetLocal, .args = {id}}});
+        }
+    }
+    size_t freeCount = base + expressions.size() - states[lastEnd + 1 - start].localCount;
+    changes.push_back(Change{.index = lastEnd + 1, .count = 0, .instr = Instruction{.op = Operation::ShrinkLocal, .args = {(uint8_t)freeCount}}});
+    // changes are applied from the end so indices of other changes stay the same
+    std::sort(changes.begin(), changes.end(), [](Change const &a, Change const &b)
+              { return a.index != b.index ? a.index > b.index : a.count > b.count; });
+    for (std::vector<Change>::const_iterator it = changes.begin(); it != changes.end(); it++)
+    {
+        if (it->count > 0)
+        {
+            m_code.replace(it->index, it->count, {it->instr});
+        }
+        else
+        {
+            m_code.insert(it->index, {it->instr});
+        }
+    }
+    return true;
+}
+
+std::vector<GobLang::Compiler::CommonSubexpressionElimination::Expression> GobLang::Compiler::CommonSubexpressionElimination::_findExpressions(size_t start, size_t end) const
+{
+    std::vector<Instruction> const &instructions = m_code.getInstructions();
+    std::vector<Expression> expressions;
+    std::vector<StackValue> stack;
+    for (size_t i = start; i < end; i++)
+    {
+        Instruction const &instr = instructions[i];
+        StackValue value = StackValue{.start = i, .isPure = true, .locals = {}, .globals = {}};
+        size_t popCount = 0;
+        size_t pushCount = 1;
+        bool isKnown = true;
+        switch (instr.op)
+        {
+        case Operation::PushConstInt:
+        case Operation::PushConstUnsignedInt:
+        case Operation::PushConstFloat:
+        case Operation::PushConstChar:
+        case Operation::PushTrue:
+        case Operation::PushFalse:
+        case Operation::PushNull:
+            break;
+        case Operation::GetLocal:
+            value.locals.insert(instr.args[0]);
+            break;
+        case Operation::GetGlobal:
+            value.globals.insert(instr.args[0]);
+            break;
+        case Operation::GetArray:
+        case Operation::GetArrayUnchecked:
+            popCount = 2;
+            value.readsArrays = true;
+            value.isExpensive = true;
+            break;
+        case Operation::GetArrayLocal:
+        case Operation::GetArrayLocalUnchecked:
+            popCount = 1;
+            value.locals.insert(instr.args[0]);
+            value.readsArrays = true;
+            value.isExpensive = true;
+            break;
+        case Operation::CallNative:
+            popCount = instr.args[1];
+            value.isExpensive = true;
+            // only results of pure functions can be reused, other calls stop tracking of the values on the stack
+            if (instr.args[0] >= m_byteCode.nativeEffects.size() || m_byteCode.nativeEffects[instr.args[0]] != NativeFunctionEffect::Pure)
+            {
+                isKnown = false;
+            }
+            break;
+        case Operation::CreateArray:
+            popCount = instr.args[0];
+            value.isPure = false;
+            break;
+        default:
+        {
+            Operation generic = getGenericOperation(instr.op);
+            int32_t effect = 0;
+            if (!getStackEffect(instr, effect))
+            {
+                isKnown = false;
+            }
+            else if (isArithmeticOperation(generic) || isComparisonOperation(generic) ||
+                     generic == Operation::And || generic == Operation::Or ||
+                     generic == Operation::Not || generic == Operation::Negate || generic == Operation::BitNot)
+            {
+                popCount = 1 - effect;
+            }
+            else
+            {
+                // other operations only remove values or leave them as is
+                popCount = effect < 0 ? -effect : 0;
+                pushCount = effect > 0 ? effect : 0;
+                value.isPure = false;
+            }
+        }
+        break;
+        }
+
+        if (!isKnown)
+        {
+            // amount of values produced by the operation is unknown, so values on the stack can't be tracked anymore
+            stack.clear();
+        }
+        else
+        {
+            for (size_t j = 0; j < popCount; j++)
+            {
+                if (stack.empty())
+                {
+                    value.isPure = false;
+                    continue;
+                }
+                StackValue const &arg = stack.back();
+                value.start = std::min(value.start, arg.start);
+                value.isPure &= arg.isPure;
+                value.isExpensive |= arg.isExpensive;
+                value.readsArrays |= arg.readsArrays;
+                value.locals.insert(arg.locals.begin(), arg.locals.end());
+                value.globals.insert(arg.globals.begin(), arg.globals.end());
+                stack.pop_back();
+            }
+            if (value.isPure && value.isExpensive && pushCount == 1)
+            {
+                std::vector<Instruction> code(instructions.begin() + value.start, instructions.begin() + i + 1);
+                std::vector<Expression>::iterator exprIt = std::find_if(expressions.begin(), expressions.end(), [&code](Expression const &expr)
+                                                                        { return expr.isAvailable && !expr.isRemoved && expr.code.size() == code.size() &&
+                                                                                 std::equal(code.begin(), code.end(), expr.code.begin(), [](Instruction const &a, Instruction const &b)
+                                                                                            { return a.op == b.op && a.args == b.args; }); });
+                if (exprIt != expressions.end())
+                {
+                    // parts of the repeated calculation are not calculated anymore
+                    for (std::vector<Expression>::iterator it = expressions.begin(); it != expressions.end(); it++)
+                    {
+                        it->repeats.erase(std::remove_if(it->repeats.begin(), it->repeats.end(), [&value, i](std::pair<size_t, size_t> const &r)
+                                                         { return r.first >= value.start && r.second <= i; }),
+                                          it->repeats.end());
+                        if (it->firstEnd >= value.start && it->firstEnd <= i)
+                        {
+                            it->isRemoved = true;
+                        }
+                    }
+                    exprIt->repeats.push_back({value.start, i});
+                }
+                else
+                {
+                    expressions.push_back(Expression{.code = code, .value = value, .firstEnd = i, .repeats = {}});
+                }
+            }
+            for (size_t j = 0; j < pushCount; j++)
+            {
+                stack.push_back(value);
+            }
+        }
+
+        // values that depend on changed variables or arrays can't be reused after this operation
+        for (std::vector<Expression>::iterator it = expressions.begin(); it != expressions.end(); it++)
+        {
+            StackValue const &exprValue = it->value;
+            switch (getInstructionEffect(instr, m_byteCode))
+            {
+            case InstructionEffect::WritesLocal:
+                it->isAvailable &= exprValue.locals.count(instr.args[0]) == 0;
+                break;
+            case InstructionEffect::WritesGlobal:
+                it->isAvailable &= exprValue.globals.count(instr.args[0]) == 0;
+                break;
+            case InstructionEffect::WritesArrays:
+                it->isAvailable &= !exprValue.readsArrays;
+                break;
+            case InstructionEffect::Unknown:
+                it->isAvailable = false;
+                break;
+            default:
+                break;
+            }
+            // freeing local variables would free the new variables instead
+            if (instr.op == Operation::ShrinkLocal)
+            {
+                it->isAvailable = false;
+            }
+        }
+    }
+    expressions.erase(std::remove_if(expressions.begin(), expressions.end(), [](Expression const &expr)
+                                     { return expr.isRemoved || expr.repeats.empty(); }),
+                      expressions.end());
+    return expressions;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <vector>
+#include <set>
+#include <cstdint>
+#include "ByteCode.hpp"
+#include "InstructionList.hpp"
+#include "ControlFlowGraph.hpp"
+namespace GobLang::Compiler
+{
+    /**
+     * @brief Pass that reuses values of array reads and pure function calls that are calculated again in the same basic block.
+     * First calculation stores the value into a new local variable, which is read by every repeated calculation and freed after the last one
+     *
+     */
+    class CommonSubexpressionElimination
+    {
+    public:
+        explicit CommonSubexpressionElimination(ByteCode const &code) : m_byteCode(code) {}
+
+        /**
+         * @brief Replace repeated calculations in all basic blocks and write the new code into the byte code
+         *
+         */
+        void optimize();
+
+        ByteCode getByteCode() const { return m_byteCode; }
+
+    private:
+        /**
+         * @brief Value that would be placed on the operation stack by the code of the block
+         *
+         */
+        struct StackValue
+        {
+            /**
+             * @brief Index of the first instruction that calculates the value
+             *
+             */
+            size_t start = 0;
+            /**
+             * @brief If true value only depends on variables and arrays and can be calculated again
+             *
+             */
+            bool isPure = false;
+            /**
+             * @brief If true calculating the value involves more than just reading variables and constants, so it is worth reusing
+             *
+             */
+            bool isExpensive = false;
+            bool readsArrays = false;
+            std::set<uint8_t> locals;
+            std::set<uint8_t> globals;
+        };
+
+        /**
+         * @brief Calculation that appears in the block more than once
+         *
+         */
+        struct Expression
+        {
+            std::vector<Instruction> code;
+            StackValue value;
+            /**
+             * @brief Index of the last instruction of the first calculation
+             *
+             */
+            size_t firstEnd;
+            /**
+             * @brief First and last instruction of each repeated calculation
+             *
+             */
+            std::vector<std::pair<size_t, size_t>> repeats;
+            /**
+             * @brief If false, values used by the expression were changed and it can't be reused anymore
+             *
+             */
+            bool isAvailable = true;
+            /**
+             * @brief If true first calculation is a part of a repeated calculation of a larger expression
+             *
+             */
+            bool isRemoved = false;
+        };
+
+        /**
+         * @brief Replace repeated calculations in a single basic block
+         *
+         * @param start Index of the first instruction of the block
+         * @param end Index after the last instruction of the block
+         * @param states State of the frame before each instruction of the block, indexed from the start of the block
+         * @return true Code was changed
+         */
+        bool _optimizeBlock(size_t start, size_t end, std::vector<FrameState> const &states);
+
+        /**
+         * @brief Find expressions that are calculated more than once in the basic block
+         *
+         */
+        std::vector<Expression> _findExpressions(size_t start, size_t end) const;
+
+        ByteCode m_byteCode;
+        InstructionList m_code;
+    };
+}
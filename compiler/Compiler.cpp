@@ -1,10 +1,34 @@
 #include "Compiler.hpp"
 #include "../execution/Machine.hpp"
 #include "CompilerToken.hpp"
+#include "ConstantFolding.hpp"
+#include "TypeInference.hpp"
+#include "InstructionList.hpp"
+#include "PureCallEvaluation.hpp"
+#include "FunctionInliner.hpp"
+#include "DeadCodeElimination.hpp"
+#include "BoundsCheckElimination.hpp"
+#include "LoopInvariantCodeMotion.hpp"
+#include "CommonSubexpressionElimination.hpp"
 #include <iostream>
 #include <deque>
 #include <iterator>
 
+GobLang::Compiler::Compiler::Compiler(ReversePolishGenerator const &generator) : m_generator(generator)
+{
+    // calls in code that can never run don't have to be evaluated
+    m_passManager.addPass<DeadCodeElimination>("dce");
+    // main code is generated before functions, so calls can only be evaluated or inlined once all code is generated
+    m_passManager.addPass<PureCallEvaluation>("eval");
+    m_passManager.addPass<FunctionInliner>("inline");
+    // functions that were inlined everywhere are not called anymore
+    m_passManager.addPass<DeadCodeElimination>("dce");
+    // loop conditions must be checked before size of the array is moved out of them
+    m_passManager.addPass<BoundsCheckElimination>("bounds_check");
+    m_passManager.addPass<LoopInvariantCodeMotion>("licm");
+    m_passManager.addPass<CommonSubexpressionElimination>("cse");
+}
+
 void GobLang::Compiler::Compiler::generateByteCode()
 {
     if (m_generator.getCode().empty())
@@ -19,6 +43,12 @@ void GobLang::Compiler::Compiler::generateByteCode()
         m_byteCode.functions.rbegin()->start = m_byteCode.operations.size();
         _generateBytecodeFor((*it)->getTokens(), false);
     }
+    m_byteCode = m_passManager.run(m_byteCode);
+}
+
+void GobLang::Compiler::Compiler::declareNativeFunction(std::string const &name, NativeFunctionEffect effect)
+{
+    m_nativeFunctions[name] = effect;
 }
 
 std::vector<uint8_t> GobLang::Compiler::Compiler::generateGetByteCode(Token *token)
@@ -113,6 +143,106 @@ void GobLang::Compiler::Compiler::appendByteCode(std::vector<uint8_t> const &byt
     m_byteCode.operations.insert(m_byteCode.operations.end(), bytes.begin(), bytes.end());
 }
 
+bool GobLang::Compiler::Compiler::_appendLocalIncrement(std::vector<uint8_t> const &valueBytes, std::vector<uint8_t> const &setBytes)
+{
+    // only 'x = x + n' and 'x = x - n' can be replaced, which is 'get x, push_int n, add/sub, set x'
+    if (setBytes.size() != 2 || setBytes[0] != (uint8_t)Operation::SetLocal)
+    {
+        return false;
+    }
+    if (valueBytes.size() != 4 + sizeof(int32_t) ||
+        valueBytes[0] != (uint8_t)Operation::GetLocal ||
+        valueBytes[1] != setBytes[1] ||
+        valueBytes[2] != (uint8_t)Operation::PushConstInt)
+    {
+        return false;
+    }
+    Operation op = getGenericOperation((Operation)valueBytes.back());
+    if (op != Operation::Add && op != Operation::Sub)
+    {
+        return false;
+    }
+    uint32_t rawDelta = 0;
+    for (size_t i = 0; i < sizeof(int32_t); i++)
+    {
+        rawDelta = (rawDelta << 8) | valueBytes[3 + i];
+    }
+    int32_t delta = (int32_t)rawDelta;
+    if (op == Operation::Sub)
+    {
+        if (delta == INT32_MIN)
+        {
+            return false;
+        }
+        delta = -delta;
+    }
+    m_byteCode.operations.push_back((uint8_t)Operation::IncrementLocal);
+    m_byteCode.operations.push_back(setBytes[1]);
+    std::vector<uint8_t> deltaBytes = parseToBytes(delta);
+    appendByteCode(deltaBytes);
+    return true;
+}
+
+bool GobLang::Compiler::Compiler::_hasModifyingCall(std::vector<uint8_t> const &bytes) const
+{
+    ByteCode code;
+    code.operations = bytes;
+    InstructionList list;
+    if (!list.decode(code))
+    {
+        return true;
+    }
+    for (std::vector<Instruction>::const_iterator it = list.getInstructions().begin(); it != list.getInstructions().end(); it++)
+    {
+        switch (it->op)
+        {
+        case Operation::Call:
+        case Operation::CallLocal:
+        case Operation::TailCallLocal:
+            return true;
+        case Operation::CallNative:
+            if (m_byteCode.nativeEffects[it->args[0]] == NativeFunctionEffect::Any)
+            {
+                return true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return false;
+}
+
+std::vector<uint8_t> GobLang::Compiler::Compiler::_generateConditionalJump(std::vector<uint8_t> const &condBytes)
+{
+    std::vector<uint8_t> out;
+    if (!condBytes.empty() && isComparisonOperation(getGenericOperation((Operation)condBytes.back())))
+    {
+        uint8_t op = (uint8_t)getGenericOperation((Operation)condBytes.back());
+        // 'get a, get b, <cmp>'
+        if (condBytes.size() == 5 &&
+            condBytes[0] == (uint8_t)Operation::GetLocal &&
+            condBytes[2] == (uint8_t)Operation::GetLocal)
+        {
+            out = {(uint8_t)Operation::JumpIfNotCompareLocals, condBytes[1], condBytes[3], op};
+            return out;
+        }
+        // 'get a, push_int n, <cmp>'
+        if (condBytes.size() == 4 + sizeof(int32_t) &&
+            condBytes[0] == (uint8_t)Operation::GetLocal &&
+            condBytes[2] == (uint8_t)Operation::PushConstInt)
+        {
+            out = {(uint8_t)Operation::JumpIfNotCompareLocalConst, condBytes[1]};
+            out.insert(out.end(), condBytes.begin() + 3, condBytes.begin() + 3 + sizeof(int32_t));
+            out.push_back(op);
+            return out;
+        }
+    }
+    out = condBytes;
+    out.push_back((uint8_t)Operation::JumpIfNot);
+    return out;
+}
+
 void GobLang::Compiler::Compiler::printLocalFunctionInfo()
 {
     for (std::vector<Function>::const_iterator it = m_byteCode.functions.begin(); it != m_byteCode.functions.end(); it++)
@@ -121,8 +251,102 @@ void GobLang::Compiler::Compiler::printLocalFunctionInfo()
     }
 }
 
+GobLang::Compiler::CompilerNode *GobLang::Compiler::Compiler::_generateShortCircuit(
+    Operation op,
+    CompilerNode *left,
+    CompilerNode *right,
+    bool isDestination,
+    size_t destMark)
+{
+    // '&&' skips right side if left side is false and '||' if it is true
+    bool skipValue = op == Operation::Or;
+    // left side is checked by the jump, while the right side needs a separate check unless it always produces a bool
+    bool checkRight = !right->hasKnownType() || right->getKnownType() != Type::Bool;
+    if (ConstantCompilerNode *constLeft = dynamic_cast<ConstantCompilerNode *>(left);
+        constLeft != nullptr && constLeft->getValue().type == Type::Bool)
+    {
+        if (constLeft->getValue().value.boolean == skipValue)
+        {
+            return new ConstantCompilerNode(constLeft->getValue(), isDestination, destMark);
+        }
+        if (ConstantCompilerNode *constRight = dynamic_cast<ConstantCompilerNode *>(right);
+            constRight != nullptr && constRight->getValue().type == Type::Bool)
+        {
+            return new ConstantCompilerNode(constRight->getValue(), isDestination, destMark);
+        }
+        std::vector<uint8_t> bytes = right->getOperationGetBytes();
+        if (checkRight)
+        {
+            bytes.push_back((uint8_t)Operation::CheckBool);
+        }
+        OperationCompilerNode *node = new OperationCompilerNode(bytes, isDestination, destMark);
+        node->setKnownType(Type::Bool);
+        return node;
+    }
+    std::vector<uint8_t> bytes = left->getOperationGetBytes();
+    std::vector<uint8_t> rightBytes = right->getOperationGetBytes();
+    if (checkRight)
+    {
+        rightBytes.push_back((uint8_t)Operation::CheckBool);
+    }
+    bytes.push_back((uint8_t)(skipValue ? Operation::JumpIfOrPop : Operation::JumpIfNotOrPop));
+    // jump distance is relative, so the bytes stay valid wherever this node ends up
+    size_t distance = rightBytes.size();
+    for (int32_t i = sizeof(size_t) - 1; i >= 0; i--)
+    {
+        bytes.push_back((uint8_t)(distance >> (i * 8)));
+    }
+    bytes.insert(bytes.end(), rightBytes.begin(), rightBytes.end());
+    OperationCompilerNode *node = new OperationCompilerNode(bytes, isDestination, destMark);
+    // both sides are checked, so the result is always a bool
+    node->setKnownType(Type::Bool);
+    return node;
+}
+
+void GobLang::Compiler::Compiler::_findSingleAssignmentLocals(std::vector<Token *> const &tokens)
+{
+    // ids are reused once the block that declared the variable ends, but any use of the id after that has to be a new declaration
+    std::map<size_t, LocalVarToken const *> currentDeclarations;
+    std::map<LocalVarToken const *, size_t> assignmentCounts;
+    for (std::vector<Token *>::const_iterator it = tokens.begin(); it != tokens.end(); it++)
+    {
+        LocalVarToken const *localToken = dynamic_cast<LocalVarToken const *>(*it);
+        if (localToken == nullptr)
+        {
+            continue;
+        }
+        if (localToken->isDeclaration())
+        {
+            currentDeclarations[localToken->getId()] = localToken;
+            assignmentCounts[localToken] = localToken->isAssigned() ? 1 : 0;
+            continue;
+        }
+        std::map<size_t, LocalVarToken const *>::const_iterator declIt = currentDeclarations.find(localToken->getId());
+        if (declIt == currentDeclarations.end())
+        {
+            continue;
+        }
+        m_localDeclarations[localToken] = declIt->second;
+        if (localToken->isAssigned())
+        {
+            assignmentCounts[declIt->second]++;
+        }
+    }
+    for (std::map<LocalVarToken const *, size_t>::const_iterator it = assignmentCounts.begin(); it != assignmentCounts.end(); it++)
+    {
+        if (it->second == 1)
+        {
+            m_singleAssignmentLocals.insert(it->first);
+        }
+    }
+}
+
 void GobLang::Compiler::Compiler::_generateBytecodeFor(std::vector<Token *> const &tokens, bool createHaltInstruction)
 {
+    _findSingleAssignmentLocals(tokens);
+    TypeInference inference(tokens, m_localDeclarations);
+    inference.run();
+    m_localTypes = inference.getLocalTypes();
     std::vector<CompilerNode *> stack;
     for (std::vector<Token *>::const_iterator it = tokens.begin(); it != tokens.end(); it++)
     {
@@ -149,25 +373,56 @@ void GobLang::Compiler::Compiler::_generateBytecodeFor(std::vector<Token *> cons
 
         else if (BoolConstToken *boolToken = dynamic_cast<BoolConstToken *>(*it); boolToken != nullptr)
         {
-            stack.push_back(new OperationCompilerNode(
-                {(uint8_t)(boolToken->getValue() ? Operation::PushTrue : Operation::PushFalse)}, isDestination, destMark));
+            stack.push_back(new ConstantCompilerNode(MemoryValue{.type = Type::Bool, .value = boolToken->getValue()}, isDestination, destMark));
+        }
+        else if (IntToken *intToken = dynamic_cast<IntToken *>(*it); intToken != nullptr)
+        {
+            stack.push_back(new ConstantCompilerNode(MemoryValue{.type = Type::Int, .value = intToken->getValue()}, isDestination, destMark));
+        }
+        else if (UnsignedIntToken *uintToken = dynamic_cast<UnsignedIntToken *>(*it); uintToken != nullptr)
+        {
+            stack.push_back(new ConstantCompilerNode(MemoryValue{.type = Type::UnsignedInt, .value = uintToken->getValue()}, isDestination, destMark));
+        }
+        else if (FloatToken *floatToken = dynamic_cast<FloatToken *>(*it); floatToken != nullptr)
+        {
+            stack.push_back(new ConstantCompilerNode(MemoryValue{.type = Type::Float, .value = floatToken->getValue()}, isDestination, destMark));
         }
-        else if (dynamic_cast<IntToken *>(*it) != nullptr ||
-                 dynamic_cast<UnsignedIntToken *>(*it) != nullptr ||
-                 dynamic_cast<StringToken *>(*it) != nullptr ||
-                 dynamic_cast<CharToken *>(*it) != nullptr ||
-                 dynamic_cast<FloatToken *>(*it) != nullptr ||
+        else if (CharToken *charToken = dynamic_cast<CharToken *>(*it); charToken != nullptr)
+        {
+            stack.push_back(new ConstantCompilerNode(MemoryValue{.type = Type::Char, .value = charToken->getChar()}, isDestination, destMark));
+        }
+        else if (dynamic_cast<StringToken *>(*it) != nullptr ||
                  dynamic_cast<NullConstToken *>(*it) != nullptr)
         {
             stack.push_back(new OperationCompilerNode(generateGetByteCode(*it), isDestination, destMark));
         }
-        else if (dynamic_cast<IdToken *>(*it) != nullptr)
+        else if (IdToken *idToken = dynamic_cast<IdToken *>(*it); idToken != nullptr)
         {
-            stack.push_back(new TokenCompilerNode(*it, isDestination, destMark));
+            stack.push_back(new GlobalVarCompilerNode(_getGlobalSlot(idToken->getId()), idToken->getId(), isDestination, destMark));
         }
-        else if (dynamic_cast<LocalVarToken *>(*it) != nullptr)
+        else if (LocalVarToken *localToken = dynamic_cast<LocalVarToken *>(*it); localToken != nullptr)
         {
-            stack.push_back(new LocalVarTokenCompilerNode(*it, isDestination, destMark));
+            // reading a variable that never changes after being set to a constant is the same as using the constant
+            std::map<LocalVarToken const *, LocalVarToken const *>::const_iterator declIt = m_localDeclarations.find(localToken);
+            std::map<LocalVarToken const *, MemoryValue>::const_iterator constIt =
+                declIt != m_localDeclarations.end() ? m_constantLocals.find(declIt->second) : m_constantLocals.end();
+            if (!localToken->isAssigned() && constIt != m_constantLocals.end())
+            {
+                stack.push_back(new ConstantCompilerNode(constIt->second, isDestination, destMark));
+            }
+            else
+            {
+                LocalVarTokenCompilerNode *localNode = new LocalVarTokenCompilerNode(*it, isDestination, destMark);
+                LocalVarToken const *declaration = localToken->isDeclaration() ? localToken
+                                                   : declIt != m_localDeclarations.end() ? declIt->second
+                                                                                         : nullptr;
+                if (std::map<LocalVarToken const *, Type>::const_iterator typeIt = m_localTypes.find(declaration);
+                    typeIt != m_localTypes.end())
+                {
+                    localNode->setKnownType(typeIt->second);
+                }
+                stack.push_back(localNode);
+            }
         }
         else if (JumpDestinationToken *destToken = dynamic_cast<JumpDestinationToken *>(*it); destToken != nullptr)
         {
@@ -184,8 +439,7 @@ void GobLang::Compiler::Compiler::_generateBytecodeFor(std::vector<Token *> cons
                 CompilerNode *cond = *stack.rbegin();
                 stack.pop_back();
                 // condition goes first and we don't care about anything else
-                bytes = cond->getOperationGetBytes();
-                bytes.push_back((uint8_t)Operation::JumpIfNot);
+                bytes = _generateConditionalJump(cond->getOperationGetBytes());
                 delete cond;
             }
             else if (WhileToken *whileTok = dynamic_cast<WhileToken *>(jmpToken); whileTok != nullptr)
@@ -197,8 +451,7 @@ void GobLang::Compiler::Compiler::_generateBytecodeFor(std::vector<Token *> cons
                 CompilerNode *cond = *stack.rbegin();
                 stack.pop_back();
                 // condition goes first and we don't care about anything else
-                bytes = cond->getOperationGetBytes();
-                bytes.push_back((uint8_t)Operation::JumpIfNot);
+                bytes = _generateConditionalJump(cond->getOperationGetBytes());
                 delete cond;
             }
             else
@@ -245,13 +498,30 @@ void GobLang::Compiler::Compiler::_generateBytecodeFor(std::vector<Token *> cons
                 {
                     CompilerNode *funcNode = *stack.rbegin();
                     stack.pop_back();
-                    std::vector<uint8_t> fTemp = funcNode->getOperationGetBytes();
-                    bytes.insert(bytes.end(), fTemp.begin(), fTemp.end());
+                    if (GlobalVarCompilerNode *globalNode = dynamic_cast<GlobalVarCompilerNode *>(funcNode);
+                        globalNode != nullptr && m_nativeFunctions.count(m_byteCode.ids[globalNode->getNameId()]) > 0)
+                    {
+                        bytes.push_back((uint8_t)Operation::CallNative);
+                        bytes.push_back(_getNativeFunctionId(globalNode->getNameId()));
+                        bytes.push_back((uint8_t)multiTok->getArgCount());
+                    }
+                    else
+                    {
+                        std::vector<uint8_t> fTemp = funcNode->getOperationGetBytes();
+                        bytes.insert(bytes.end(), fTemp.begin(), fTemp.end());
+                        bytes.push_back((uint8_t)Operation::Call);
+                    }
                     delete funcNode;
-                    bytes.push_back((uint8_t)Operation::Call);
                 }
             }
-            stack.push_back(new OperationCompilerNode(bytes, isDestination, destMark));
+            if (FunctionCallToken *func = dynamic_cast<FunctionCallToken *>(*it); func != nullptr && func->usesLocalFunction())
+            {
+                stack.push_back(new LocalCallCompilerNode(bytes, isDestination, destMark));
+            }
+            else
+            {
+                stack.push_back(new OperationCompilerNode(bytes, isDestination, destMark));
+            }
         }
         else if (ReturnToken *ret = dynamic_cast<ReturnToken *>(*it); ret != nullptr)
         {
@@ -259,8 +529,16 @@ void GobLang::Compiler::Compiler::_generateBytecodeFor(std::vector<Token *> cons
             {
                 CompilerNode *val = *stack.rbegin();
                 stack.pop_back();
-                appendCompilerNode(val, true);
-                m_byteCode.operations.push_back((uint8_t)Operation::ReturnValue);
+                if (LocalCallCompilerNode *callNode = dynamic_cast<LocalCallCompilerNode *>(val); callNode != nullptr)
+                {
+                    // returning result of another call doesn't need the current frame anymore
+                    appendByteCode(callNode->getTailCallBytes());
+                }
+                else
+                {
+                    appendCompilerNode(val, true);
+                    m_byteCode.operations.push_back((uint8_t)Operation::ReturnValue);
+                }
                 delete val;
             }
             else
@@ -280,9 +558,23 @@ void GobLang::Compiler::Compiler::_generateBytecodeFor(std::vector<Token *> cons
                 // 'not' only uses one argument
                 CompilerNode *value = stack[stack.size() - 1];
                 stack.pop_back();
+                MemoryValue folded;
+                if (ConstantCompilerNode *constNode = dynamic_cast<ConstantCompilerNode *>(value);
+                    constNode != nullptr && foldUnaryOperation(opToken->getOperation(), constNode->getValue(), folded))
+                {
+                    stack.push_back(new ConstantCompilerNode(folded, isDestination, destMark));
+                    delete value;
+                    continue;
+                }
                 std::vector<uint8_t> opBytes = value->getOperationGetBytes();
                 opBytes.push_back((uint8_t)opToken->getOperation());
-                stack.push_back(new OperationCompilerNode(opBytes, isDestination, destMark));
+                OperationCompilerNode *opNode = new OperationCompilerNode(opBytes, isDestination, destMark);
+                Type resultType;
+                if (value->hasKnownType() && getUnaryOperationType(opToken->getOperation(), value->getKnownType(), resultType))
+                {
+                    opNode->setKnownType(resultType);
+                }
+                stack.push_back(opNode);
                 delete value;
                 continue;
             }
@@ -290,12 +582,28 @@ void GobLang::Compiler::Compiler::_generateBytecodeFor(std::vector<Token *> cons
             CompilerNode *valueToSet = stack[stack.size() - 1];
             stack.pop_back();
             stack.pop_back();
+            // variables only need the value on the stack, while arrays need array and index to be placed first
+            bool isVariable = dynamic_cast<LocalVarTokenCompilerNode *>(setter) != nullptr ||
+                              dynamic_cast<GlobalVarCompilerNode *>(setter) != nullptr;
             if (opToken->getOperator() == Operator::Assign)
             {
-                if (LocalVarTokenCompilerNode *localNode = dynamic_cast<LocalVarTokenCompilerNode *>(setter); localNode != nullptr)
+                if (isVariable)
                 {
-                    appendCompilerNode(valueToSet, true);
-                    appendByteCode(localNode->getOperationSetBytes());
+                    LocalVarTokenCompilerNode *localNode = dynamic_cast<LocalVarTokenCompilerNode *>(setter);
+                    ConstantCompilerNode *constNode = dynamic_cast<ConstantCompilerNode *>(valueToSet);
+                    if (localNode != nullptr && constNode != nullptr)
+                    {
+                        LocalVarToken const *localToken = static_cast<LocalVarToken const *>(localNode->getToken());
+                        if (m_singleAssignmentLocals.count(localToken) > 0)
+                        {
+                            m_constantLocals[localToken] = constNode->getValue();
+                        }
+                    }
+                    if (!_appendLocalIncrement(valueToSet->getOperationGetBytes(), setter->getOperationSetBytes()))
+                    {
+                        appendCompilerNode(valueToSet, true);
+                        appendCompilerNode(setter, false);
+                    }
                 }
                 else
                 {
@@ -314,18 +622,49 @@ void GobLang::Compiler::Compiler::_generateBytecodeFor(std::vector<Token *> cons
             // handle '+=' and such
             else if (opToken->isAssignment())
             {
+                Operation op = opToken->getOperation();
+                std::vector<uint8_t> setBytes = setter->getOperationSetBytes();
                 std::vector<uint8_t> opBytes;
                 std::vector<uint8_t> aBytes = setter->getOperationGetBytes();
                 std::vector<uint8_t> bBytes = valueToSet->getOperationGetBytes();
 
                 opBytes.insert(opBytes.end(), aBytes.begin(), aBytes.end());
                 opBytes.insert(opBytes.end(), bBytes.begin(), bBytes.end());
-                opBytes.push_back((uint8_t)opToken->getOperation());
+                opBytes.push_back((uint8_t)op);
 
-                if (LocalVarTokenCompilerNode *localNode = dynamic_cast<LocalVarTokenCompilerNode *>(setter); localNode != nullptr)
+                if (isVariable)
                 {
-                    appendByteCode(opBytes);
-                    appendCompilerNode(localNode, false);
+                    if (_appendLocalIncrement(opBytes, setBytes))
+                    {
+                        // constant int increments have their own operation
+                    }
+                    else if (isArithmeticOperation(op) && setBytes.size() == 2 &&
+                             (setBytes[0] == (uint8_t)Operation::SetLocal ||
+                              (setBytes[0] == (uint8_t)Operation::SetGlobal && !_hasModifyingCall(bBytes))))
+                    {
+                        // variable is modified in place, so only the value has to be calculated.
+                        // globals are read after the value, which is only the same as reading them first if the value can't change them
+                        appendCompilerNode(valueToSet, true);
+                        m_byteCode.operations.push_back(
+                            (uint8_t)(setBytes[0] == (uint8_t)Operation::SetLocal ? Operation::OperateLocal : Operation::OperateGlobal));
+                        m_byteCode.operations.push_back(setBytes[1]);
+                        m_byteCode.operations.push_back((uint8_t)op);
+                    }
+                    else
+                    {
+                        appendByteCode(opBytes);
+                        appendCompilerNode(setter, false);
+                    }
+                }
+                else if (ArrayCompilerNode *arrNode = dynamic_cast<ArrayCompilerNode *>(setter);
+                         arrNode != nullptr && isArithmeticOperation(op) && !_hasModifyingCall(bBytes))
+                {
+                    // array and index are calculated once and reused for both reading and writing the item.
+                    // item is read after the value, which is only the same as reading it first if the value can't change it
+                    appendCompilerNode(setter, false);
+                    appendCompilerNode(valueToSet, true);
+                    m_byteCode.operations.push_back((uint8_t)Operation::OperateArray);
+                    m_byteCode.operations.push_back((uint8_t)op);
                 }
                 else
                 {
@@ -341,16 +680,50 @@ void GobLang::Compiler::Compiler::_generateBytecodeFor(std::vector<Token *> cons
                     }
                 }
             }
+            else if (opToken->getOperation() == Operation::And || opToken->getOperation() == Operation::Or)
+            {
+                stack.push_back(_generateShortCircuit(opToken->getOperation(), setter, valueToSet, isDestination, destMark));
+            }
             else
             {
-                std::vector<uint8_t> opBytes;
-                std::vector<uint8_t> aBytes = setter->getOperationGetBytes();
-                std::vector<uint8_t> bBytes = valueToSet->getOperationGetBytes();
+                ConstantCompilerNode *constA = dynamic_cast<ConstantCompilerNode *>(setter);
+                ConstantCompilerNode *constB = dynamic_cast<ConstantCompilerNode *>(valueToSet);
+                MemoryValue folded;
+                if (constA != nullptr && constB != nullptr &&
+                    foldBinaryOperation(opToken->getOperation(), constA->getValue(), constB->getValue(), folded))
+                {
+                    stack.push_back(new ConstantCompilerNode(folded, isDestination, destMark));
+                }
+                else
+                {
+                    Operation op = opToken->getOperation();
+                    bool isTypeKnown = setter->hasKnownType() && valueToSet->hasKnownType();
+                    // operands that are proven to be ints or floats can use operations that skip type checks
+                    if (isTypeKnown && setter->getKnownType() == valueToSet->getKnownType())
+                    {
+                        op = getSpecializedOperation(op, setter->getKnownType());
+                    }
+                    std::vector<uint8_t> opBytes;
+                    std::vector<uint8_t> aBytes = setter->getOperationGetBytes();
+                    std::vector<uint8_t> bBytes = valueToSet->getOperationGetBytes();
 
-                opBytes.insert(opBytes.end(), aBytes.begin(), aBytes.end());
-                opBytes.insert(opBytes.end(), bBytes.begin(), bBytes.end());
-                opBytes.push_back((uint8_t)opToken->getOperation());
-                stack.push_back(new OperationCompilerNode(opBytes, isDestination, destMark));
+                    opBytes.insert(opBytes.end(), aBytes.begin(), aBytes.end());
+                    opBytes.insert(opBytes.end(), bBytes.begin(), bBytes.end());
+                    opBytes.push_back((uint8_t)op);
+                    OperationCompilerNode *opNode = new OperationCompilerNode(opBytes, isDestination, destMark);
+                    Type resultType;
+                    if (isTypeKnown &&
+                        getBinaryOperationType(opToken->getOperation(), setter->getKnownType(), valueToSet->getKnownType(), resultType))
+                    {
+                        opNode->setKnownType(resultType);
+                    }
+                    // comparison either fails or produces a bool, whatever the types of the operands are
+                    else if (isComparisonOperation(opToken->getOperation()))
+                    {
+                        opNode->setKnownType(Type::Bool);
+                    }
+                    stack.push_back(opNode);
+                }
             }
             // since they are no longer on the stack they are not accessible outside of this block
             // leaving them undeleted will make them a memory leak
@@ -390,12 +763,47 @@ void GobLang::Compiler::Compiler::_generateBytecodeFor(std::vector<Token *> cons
         }
         else
         {
-            // if we haven't recorded the mark then it means it's at the end
+            // if we haven't recorded the mark then it means it's at the end.
+            // end is recorded, so code of functions generated later doesn't move the mark to the end of the function
+            m_jumpDestinations[(*it).first] = m_byteCode.operations.size() - 1;
             _placeAddressForMark((*it).first, m_byteCode.operations.size() - 1, false);
         }
     }
 }
 
+uint8_t GobLang::Compiler::Compiler::_getGlobalSlot(size_t nameId)
+{
+    if (std::map<size_t, uint8_t>::iterator it = m_globalSlots.find(nameId); it != m_globalSlots.end())
+    {
+        return it->second;
+    }
+    if (m_byteCode.globals.size() > UINT8_MAX)
+    {
+        throw CompilerException("Too many global variables, at most " + std::to_string(UINT8_MAX + 1) + " can be used");
+    }
+    uint8_t slot = (uint8_t)m_byteCode.globals.size();
+    m_byteCode.globals.push_back(m_byteCode.ids[nameId]);
+    m_globalSlots[nameId] = slot;
+    return slot;
+}
+
+uint8_t GobLang::Compiler::Compiler::_getNativeFunctionId(size_t nameId)
+{
+    if (std::map<size_t, uint8_t>::iterator it = m_nativeFunctionIds.find(nameId); it != m_nativeFunctionIds.end())
+    {
+        return it->second;
+    }
+    if (m_byteCode.natives.size() > UINT8_MAX)
+    {
+        throw CompilerException("Too many native functions, at most " + std::to_string(UINT8_MAX + 1) + " can be called");
+    }
+    uint8_t id = (uint8_t)m_byteCode.natives.size();
+    m_byteCode.natives.push_back(m_byteCode.ids[nameId]);
+    m_byteCode.nativeEffects.push_back(m_nativeFunctions[m_byteCode.ids[nameId]]);
+    m_nativeFunctionIds[nameId] = id;
+    return id;
+}
+
 void GobLang::Compiler::Compiler::_placeAddressForMark(size_t mark, size_t address, bool erase)
 {
     for (std::vector<size_t>::iterator labelIt = m_jumpMarks[mark].begin();
@@ -417,3 +825,8 @@ void GobLang::Compiler::Compiler::_placeAddressForMark(size_t mark, size_t addre
         m_jumpMarks.erase(mark);
     }
 }
+
+const char *GobLang::Compiler::CompilerException::what() const throw()
+{
+    return m_msg.c_str();
+}
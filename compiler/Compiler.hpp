@@ -1,8 +1,10 @@
 #pragma once
 #include "ReversePolishGenerator.hpp"
 #include <vector>
+#include <set>
 #include <cstdint>
 #include "ByteCode.hpp"
+#include "PassManager.hpp"
 
 #include "CompilerNode.hpp"
 namespace GobLang::Compiler
@@ -23,10 +25,24 @@ namespace GobLang::Compiler
         return res;
     }
     
+    /**
+     * @brief Error raised when valid code can't be written as byte code, for example when it uses more names than operations can address
+     *
+     */
+    class CompilerException : public std::exception
+    {
+    public:
+        const char *what() const throw() override;
+        explicit CompilerException(std::string const &msg) : m_msg(msg) {}
+
+    private:
+        std::string m_msg;
+    };
+
     class Compiler
     {
     public:
-        explicit Compiler(ReversePolishGenerator const &generator) : m_generator(generator) {}
+        explicit Compiler(ReversePolishGenerator const &generator);
 
         /**
          * @brief Generate byte code that can be used by the interpreter and write it into the `m_byteCode` variable
@@ -34,6 +50,15 @@ namespace GobLang::Compiler
          */
         void generateByteCode();
 
+        /**
+         * @brief Mark the name as a native function that will be bound to the machine.
+         * Calls to this name will be compiled into direct native calls instead of reading the function from a global variable
+         *
+         * @param name Name of the native function
+         * @param effect What optimizations can assume about the function
+         */
+        void declareNativeFunction(std::string const &name, NativeFunctionEffect effect = NativeFunctionEffect::Any);
+
         static std::vector<uint8_t> generateGetByteCode(Token *token);
 
         static std::vector<uint8_t> generateSetByteCode(Token *token);
@@ -56,14 +81,109 @@ namespace GobLang::Compiler
 
         ByteCode getByteCode() const { return m_byteCode; }
 
+        /**
+         * @brief Passes applied to the byte code after it is generated. Passes can be disabled by name before calling `generateByteCode`
+         *
+         */
+        PassManager &getPassManager() { return m_passManager; }
+
         void printLocalFunctionInfo();
 
     private:
         void _generateBytecodeFor(std::vector<Token *> const &tokens, bool createHaltInstruction);
         void _placeAddressForMark(size_t mark, size_t address, bool erase);
 
+        /**
+         * @brief Get slot for the global variable using given name id. New slot is added to the byte code if this name was never used before
+         *
+         * @param nameId Id of the variable name in the id table
+         * @return uint8_t Slot of the global variable
+         * @throws CompilerException Code uses more global variables than a single byte can address
+         */
+        uint8_t _getGlobalSlot(size_t nameId);
+
+        /**
+         * @brief Get id for the native function with the given name id. New id is added to the byte code if this function was never called before
+         *
+         * @param nameId Id of the function name in the id table
+         * @return uint8_t Id of the native function
+         * @throws CompilerException Code calls more native functions than a single byte can address
+         */
+        uint8_t _getNativeFunctionId(size_t nameId);
+
+        /**
+         * @brief Append a single `IncrementLocal` operation if the assignment only adds or subtracts a constant int from the variable being assigned
+         *
+         * @param valueBytes Bytes that produce the value to assign
+         * @param setBytes Bytes that store the value in the variable
+         * @return true Increment was appended and nothing else needs to be generated
+         * @return false Assignment doesn't match the pattern and nothing was appended
+         */
+        bool _appendLocalIncrement(std::vector<uint8_t> const &valueBytes, std::vector<uint8_t> const &setBytes);
+
+        /**
+         * @brief Check if code calls functions that could change existing variables or arrays
+         *
+         * @param bytes Code to check
+         * @return true Code calls written functions or native functions that are not pure or read only, or can't be decoded
+         * @return false Code can't change any existing values
+         */
+        bool _hasModifyingCall(std::vector<uint8_t> const &bytes) const;
+
+        /**
+         * @brief Generate condition check followed by conditional jump operation, without the jump address.
+         * Comparisons between local variables or local variable and int constant are replaced by a single compare-and-jump operation
+         *
+         * @param condBytes Bytes that produce the condition value
+         * @return std::vector<uint8_t> Bytes of the condition and the jump operation
+         */
+        std::vector<uint8_t> _generateConditionalJump(std::vector<uint8_t> const &condBytes);
+
+        /**
+         * @brief Generate node for `&&` or `||` operation that only evaluates the right side if the left side doesn't already decide the result
+         *
+         * @param op Either `And` or `Or`
+         * @param left Node of the left side
+         * @param right Node of the right side
+         * @param isDestination Is new node a jump destination
+         * @param destMark Jump mark of the new node
+         * @return CompilerNode* New node
+         */
+        CompilerNode *_generateShortCircuit(Operation op, CompilerNode *left, CompilerNode *right, bool isDestination, size_t destMark);
+
+        /**
+         * @brief Find local variables that are assigned only once when they are declared and record which declaration each local variable token refers to
+         *
+         * @param tokens Code of the main program or a single function
+         */
+        void _findSingleAssignmentLocals(std::vector<Token *> const &tokens);
+
         std::vector<uint8_t> m_bytes;
 
+        /**
+         * @brief Declaration of the variable used by each local variable token. Function arguments have no declaration and are not stored here
+         *
+         */
+        std::map<LocalVarToken const *, LocalVarToken const *> m_localDeclarations;
+
+        /**
+         * @brief Declarations of local variables that are never assigned after being declared
+         *
+         */
+        std::set<LocalVarToken const *> m_singleAssignmentLocals;
+
+        /**
+         * @brief Values of local variables that are never changed and were declared using a constant value. Key is the declaration of the variable
+         *
+         */
+        std::map<LocalVarToken const *, MemoryValue> m_constantLocals;
+
+        /**
+         * @brief Types of local variables that always store values of the same type in the function being compiled. Key is the declaration of the variable
+         *
+         */
+        std::map<LocalVarToken const *, Type> m_localTypes;
+
         /**
          * @brief Jump map used in bytecode generation to know which places require which marks.
          * key is mark id, value are all places which require address replacement
@@ -83,8 +203,28 @@ namespace GobLang::Compiler
          */
         std::map<size_t, std::vector<size_t>> m_functionCallDestinations;
 
+        /**
+         * @brief Slots assigned to global variables. Key is id of the name and value is the slot
+         *
+         */
+        std::map<size_t, uint8_t> m_globalSlots;
+
+        /**
+         * @brief Names of all functions that were declared as native and their effects
+         *
+         */
+        std::map<std::string, NativeFunctionEffect> m_nativeFunctions;
+
+        /**
+         * @brief Ids assigned to called native functions. Key is id of the name and value is the id of the function
+         *
+         */
+        std::map<size_t, uint8_t> m_nativeFunctionIds;
+
         ByteCode m_byteCode;
 
+        PassManager m_passManager;
+
         ReversePolishGenerator const &m_generator;
     };
 
@@ -10,8 +10,49 @@ std::vector<uint8_t> GobLang::Compiler::TokenCompilerNode::getOperationSetBytes(
     return Compiler::generateSetByteCode(m_token);
 }
 
+std::vector<uint8_t> GobLang::Compiler::LocalCallCompilerNode::getTailCallBytes()
+{
+    // call is always the last operation, followed by id of the function
+    std::vector<uint8_t> out = getOperationGetBytes();
+    out[out.size() - 2] = (uint8_t)Operation::TailCallLocal;
+    return out;
+}
+
 void GobLang::Compiler::CompilerNode::setMark(size_t mark)
 {
     m_hasMark = true;
     m_attachedMark = mark;
 }
+
+std::vector<uint8_t> GobLang::Compiler::ConstantCompilerNode::getOperationGetBytes()
+{
+    std::vector<uint8_t> out;
+    std::vector<uint8_t> valueBytes;
+    switch (m_value.type)
+    {
+    case Type::Bool:
+        out.push_back((uint8_t)(m_value.value.boolean ? Operation::PushTrue : Operation::PushFalse));
+        break;
+    case Type::Char:
+        out.push_back((uint8_t)Operation::PushConstChar);
+        out.push_back((uint8_t)m_value.value.character);
+        break;
+    case Type::Int:
+        out.push_back((uint8_t)Operation::PushConstInt);
+        valueBytes = parseToBytes(m_value.value.integer);
+        break;
+    case Type::UnsignedInt:
+        out.push_back((uint8_t)Operation::PushConstUnsignedInt);
+        valueBytes = parseToBytes(m_value.value.unsignedInteger);
+        break;
+    case Type::Float:
+        out.push_back((uint8_t)Operation::PushConstFloat);
+        valueBytes = parseToBytes(m_value.value.floating);
+        break;
+    default:
+        out.push_back((uint8_t)Operation::PushNull);
+        break;
+    }
+    out.insert(out.end(), valueBytes.begin(), valueBytes.end());
+    return out;
+}
@@ -2,6 +2,7 @@
 #include <vector>
 #include <cstdint>
 #include "Token.hpp"
+#include "../execution/Value.hpp"
 namespace GobLang::Compiler
 {
 
@@ -17,11 +18,25 @@ namespace GobLang::Compiler
         size_t getMark() const { return m_attachedMark; }
         bool hasMark() const { return m_hasMark; }
 
+        /**
+         * @brief Mark that value produced by this node always has the given type
+         *
+         */
+        void setKnownType(Type type)
+        {
+            m_hasKnownType = true;
+            m_knownType = type;
+        }
+        bool hasKnownType() const { return m_hasKnownType; }
+        Type getKnownType() const { return m_knownType; }
+
         virtual ~CompilerNode() = default;
 
     private:
         bool m_hasMark;
         size_t m_attachedMark = 0;
+        bool m_hasKnownType = false;
+        Type m_knownType = Type::Null;
     };
 
     class OperationCompilerNode : public CompilerNode
@@ -38,6 +53,24 @@ namespace GobLang::Compiler
         std::vector<uint8_t> m_bytes;
     };
 
+    /**
+     * @brief Node for a call of a function written in the code
+     *
+     */
+    class LocalCallCompilerNode : public OperationCompilerNode
+    {
+    public:
+        explicit LocalCallCompilerNode(std::vector<uint8_t> const &vec,
+                                       bool isDestination,
+                                       size_t destinationId) : OperationCompilerNode(vec, isDestination, destinationId) {}
+
+        /**
+         * @brief Get bytes that perform the call reusing frame of the current function. Can only be used if result of the call is immediately returned
+         *
+         */
+        std::vector<uint8_t> getTailCallBytes();
+    };
+
     class TokenCompilerNode : public CompilerNode
     {
     public:
@@ -62,6 +95,35 @@ namespace GobLang::Compiler
                                            size_t destinationId) : TokenCompilerNode(token, isDestination, destinationId) {}
     };
 
+    /**
+     * @brief Node for a global variable that was assigned a slot during compilation
+     *
+     */
+    class GlobalVarCompilerNode : public CompilerNode
+    {
+    public:
+        explicit GlobalVarCompilerNode(uint8_t slot,
+                                       size_t nameId,
+                                       bool isDestination,
+                                       size_t destinationId) : CompilerNode(isDestination, destinationId), m_slot(slot), m_nameId(nameId) {}
+
+        std::vector<uint8_t> getOperationGetBytes() override
+        {
+            return {(uint8_t)Operation::GetGlobal, m_slot};
+        }
+
+        std::vector<uint8_t> getOperationSetBytes() override
+        {
+            return {(uint8_t)Operation::SetGlobal, m_slot};
+        }
+
+        size_t getNameId() const { return m_nameId; }
+
+    private:
+        uint8_t m_slot;
+        size_t m_nameId;
+    };
+
     class ArrayCompilerNode : public CompilerNode
     {
     public:
@@ -74,6 +136,13 @@ namespace GobLang::Compiler
         {
             std::vector<uint8_t> out = m_index->getOperationGetBytes();
             std::vector<uint8_t> arrayGetBytes = m_array->getOperationGetBytes();
+            // arrays stored in local variables can be read directly without pushing them first
+            if (arrayGetBytes.size() == 2 && arrayGetBytes[0] == (uint8_t)Operation::GetLocal)
+            {
+                out.push_back((uint8_t)Operation::GetArrayLocal);
+                out.push_back(arrayGetBytes[1]);
+                return out;
+            }
             out.insert(out.end(), arrayGetBytes.begin(), arrayGetBytes.end());
             out.push_back((uint8_t)Operation::GetArray);
             return out;
@@ -99,6 +168,28 @@ namespace GobLang::Compiler
         CompilerNode *m_index;
     };
 
+    /**
+     * @brief Node for a value of a primitive type that is known during compilation
+     *
+     */
+    class ConstantCompilerNode : public CompilerNode
+    {
+    public:
+        explicit ConstantCompilerNode(MemoryValue const &value,
+                                      bool isDestination,
+                                      size_t destinationId) : CompilerNode(isDestination, destinationId), m_value(value)
+        {
+            setKnownType(value.type);
+        }
+
+        std::vector<uint8_t> getOperationGetBytes() override;
+
+        MemoryValue const &getValue() const { return m_value; }
+
+    private:
+        MemoryValue m_value;
+    };
+
     class BoolConstCompilerNode : public CompilerNode
     {
     public:
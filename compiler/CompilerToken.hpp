@@ -104,13 +104,28 @@ namespace GobLang::Compiler
     class LocalVarToken : public Token
     {
     public:
-        explicit LocalVarToken(size_t row, size_t column, size_t id) : Token(row, column), m_varId(id) {}
+        explicit LocalVarToken(size_t row, size_t column, size_t id, bool isDeclaration = false, bool isAssigned = false)
+            : Token(row, column), m_varId(id), m_isDeclaration(isDeclaration), m_isAssigned(isAssigned) {}
         size_t getId() const { return m_varId; }
 
+        /**
+         * @brief Is this the token that declares the variable using `let`
+         *
+         */
+        bool isDeclaration() const { return m_isDeclaration; }
+
+        /**
+         * @brief Is this token used as the destination of an assignment
+         *
+         */
+        bool isAssigned() const { return m_isAssigned; }
+
         std::string toString() override { return "LOC" + std::to_string(m_varId); }
 
     private:
         size_t m_varId;
+        bool m_isDeclaration;
+        bool m_isAssigned;
     };
 
     class LocalVarShrinkToken : public Token
@@ -0,0 +1,242 @@
+#include "ConstantFolding.hpp"
+#include <cstdint>
+
+bool GobLang::Compiler::foldBinaryOperation(Operation op, MemoryValue const &a, MemoryValue const &b, MemoryValue &result)
+{
+    // every operation supported by the machine requires both values to have the same type
+    if (a.type != b.type)
+    {
+        return false;
+    }
+    switch (op)
+    {
+    case Operation::Add:
+    case Operation::Sub:
+    case Operation::Mul:
+    case Operation::Div:
+    case Operation::Modulo:
+        if (a.type == Type::Int)
+        {
+            // signed overflow wraps around at runtime, so calculations are done using unsigned values to get the same result
+            uint32_t left = (uint32_t)a.value.integer;
+            uint32_t right = (uint32_t)b.value.integer;
+            switch (op)
+            {
+            case Operation::Add:
+                result = MemoryValue{.type = Type::Int, .value = (int32_t)(left + right)};
+                return true;
+            case Operation::Sub:
+                result = MemoryValue{.type = Type::Int, .value = (int32_t)(left - right)};
+                return true;
+            case Operation::Mul:
+                result = MemoryValue{.type = Type::Int, .value = (int32_t)(left * right)};
+                return true;
+            default:
+                break;
+            }
+            // division by zero and INT32_MIN / -1 fail at runtime, so they have to stay in the code
+            if (b.value.integer == 0 || (a.value.integer == INT32_MIN && b.value.integer == -1))
+            {
+                return false;
+            }
+            result = MemoryValue{
+                .type = Type::Int,
+                .value = op == Operation::Div ? a.value.integer / b.value.integer : a.value.integer % b.value.integer};
+            return true;
+        }
+        else if (a.type == Type::UnsignedInt)
+        {
+            uint32_t left = a.value.unsignedInteger;
+            uint32_t right = b.value.unsignedInteger;
+            switch (op)
+            {
+            case Operation::Add:
+                result = MemoryValue{.type = Type::UnsignedInt, .value = left + right};
+                return true;
+            case Operation::Sub:
+                result = MemoryValue{.type = Type::UnsignedInt, .value = left - right};
+                return true;
+            case Operation::Mul:
+                result = MemoryValue{.type = Type::UnsignedInt, .value = left * right};
+                return true;
+            default:
+                break;
+            }
+            if (right == 0)
+            {
+                return false;
+            }
+            result = MemoryValue{.type = Type::UnsignedInt, .value = op == Operation::Div ? left / right : left % right};
+            return true;
+        }
+        else if (a.type == Type::Float)
+        {
+            float left = a.value.floating;
+            float right = b.value.floating;
+            switch (op)
+            {
+            case Operation::Add:
+                result = MemoryValue{.type = Type::Float, .value = left + right};
+                return true;
+            case Operation::Sub:
+                result = MemoryValue{.type = Type::Float, .value = left - right};
+                return true;
+            case Operation::Mul:
+                result = MemoryValue{.type = Type::Float, .value = left * right};
+                return true;
+            case Operation::Div:
+                result = MemoryValue{.type = Type::Float, .value = left / right};
+                return true;
+            default:
+                // modulo is not supported for floats
+                return false;
+            }
+        }
+        return false;
+    case Operation::BitAnd:
+    case Operation::BitOr:
+    case Operation::BitXor:
+    case Operation::ShiftLeft:
+    case Operation::ShiftRight:
+    {
+        if (a.type != Type::Int && a.type != Type::UnsignedInt)
+        {
+            return false;
+        }
+        uint32_t left = a.type == Type::Int ? (uint32_t)a.value.integer : a.value.unsignedInteger;
+        uint32_t right = a.type == Type::Int ? (uint32_t)b.value.integer : b.value.unsignedInteger;
+        uint32_t res = 0;
+        switch (op)
+        {
+        case Operation::BitAnd:
+            res = left & right;
+            break;
+        case Operation::BitOr:
+            res = left | right;
+            break;
+        case Operation::BitXor:
+            res = left ^ right;
+            break;
+        default:
+            // shifting by negative amount or by more bits than the value has is not defined, so it is left for the runtime
+            if (right >= 32)
+            {
+                return false;
+            }
+            if (op == Operation::ShiftLeft)
+            {
+                res = left << right;
+            }
+            else
+            {
+                res = a.type == Type::Int ? (uint32_t)(a.value.integer >> right) : left >> right;
+            }
+            break;
+        }
+        if (a.type == Type::Int)
+        {
+            result = MemoryValue{.type = Type::Int, .value = (int32_t)res};
+        }
+        else
+        {
+            result = MemoryValue{.type = Type::UnsignedInt, .value = res};
+        }
+        return true;
+    }
+    case Operation::Equals:
+    case Operation::NotEq:
+        switch (a.type)
+        {
+        case Type::Bool:
+        case Type::Char:
+        case Type::Int:
+        case Type::UnsignedInt:
+        case Type::Float:
+            result = MemoryValue{.type = Type::Bool, .value = areEqual(a, b) == (op == Operation::Equals)};
+            return true;
+        default:
+            return false;
+        }
+    case Operation::Less:
+    case Operation::More:
+    case Operation::LessOrEq:
+    case Operation::MoreOrEq:
+    {
+        bool res = false;
+        if (a.type == Type::Int)
+        {
+            int32_t left = a.value.integer;
+            int32_t right = b.value.integer;
+            res = op == Operation::Less ? left < right : op == Operation::More ? left > right
+                                                     : op == Operation::LessOrEq ? left <= right
+                                                                                 : left >= right;
+        }
+        else if (a.type == Type::Float)
+        {
+            float left = a.value.floating;
+            float right = b.value.floating;
+            res = op == Operation::Less ? left < right : op == Operation::More ? left > right
+                                                     : op == Operation::LessOrEq ? left <= right
+                                                                                 : left >= right;
+        }
+        else
+        {
+            return false;
+        }
+        result = MemoryValue{.type = Type::Bool, .value = res};
+        return true;
+    }
+    case Operation::And:
+    case Operation::Or:
+        if (a.type != Type::Bool)
+        {
+            return false;
+        }
+        result = MemoryValue{
+            .type = Type::Bool,
+            .value = op == Operation::And ? a.value.boolean && b.value.boolean : a.value.boolean || b.value.boolean};
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool GobLang::Compiler::foldUnaryOperation(Operation op, MemoryValue const &a, MemoryValue &result)
+{
+    switch (op)
+    {
+    case Operation::Not:
+        if (a.type != Type::Bool)
+        {
+            return false;
+        }
+        result = MemoryValue{.type = Type::Bool, .value = !a.value.boolean};
+        return true;
+    case Operation::Negate:
+        if (a.type == Type::Int)
+        {
+            result = MemoryValue{.type = Type::Int, .value = (int32_t)(0u - (uint32_t)a.value.integer)};
+            return true;
+        }
+        else if (a.type == Type::Float)
+        {
+            result = MemoryValue{.type = Type::Float, .value = -a.value.floating};
+            return true;
+        }
+        return false;
+    case Operation::BitNot:
+        if (a.type == Type::Int)
+        {
+            result = MemoryValue{.type = Type::Int, .value = ~a.value.integer};
+            return true;
+        }
+        else if (a.type == Type::UnsignedInt)
+        {
+            result = MemoryValue{.type = Type::UnsignedInt, .value = ~a.value.unsignedInteger};
+            return true;
+        }
+        return false;
+    default:
+        return false;
+    }
+}
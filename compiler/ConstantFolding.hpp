@@ -0,0 +1,28 @@
+#pragma once
+#include "../execution/Value.hpp"
+#include "../execution/Operations.hpp"
+namespace GobLang::Compiler
+{
+    /**
+     * @brief Calculate result of a binary operation on two values known during compilation, producing exactly the same value the machine would produce at runtime
+     *
+     * @param op Operation to perform
+     * @param a Left operand
+     * @param b Right operand
+     * @param result Where to write the result
+     * @return true Result was calculated
+     * @return false Operation can't be calculated ahead of time, either because it is not supported or because it would fail at runtime
+     */
+    bool foldBinaryOperation(Operation op, MemoryValue const &a, MemoryValue const &b, MemoryValue &result);
+
+    /**
+     * @brief Calculate result of a unary operation on a value known during compilation, producing exactly the same value the machine would produce at runtime
+     *
+     * @param op Operation to perform
+     * @param a Operand
+     * @param result Where to write the result
+     * @return true Result was calculated
+     * @return false Operation can't be calculated ahead of time, either because it is not supported or because it would fail at runtime
+     */
+    bool foldUnaryOperation(Operation op, MemoryValue const &a, MemoryValue &result);
+}
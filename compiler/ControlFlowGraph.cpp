@@ -0,0 +1,201 @@
+#include "ControlFlowGraph.hpp"
+#include <algorithm>
+
+bool GobLang::Compiler::ControlFlowGraph::build(InstructionList const &code, size_t start, size_t argCount)
+{
+    m_instructions = &code.getInstructions();
+    m_start = start;
+    m_end = code.getCodeEnd(start);
+    m_blocks.clear();
+    m_blockOf.clear();
+    m_blockDefinitions.clear();
+    if (!code.findFrameStates(m_start, m_end, argCount, false, m_states))
+    {
+        return false;
+    }
+    std::vector<Instruction> const &instructions = *m_instructions;
+    // blocks start at jump targets and after operations that jump
+    std::vector<bool> isBlockStart(m_end - m_start + 1, false);
+    isBlockStart[0] = true;
+    for (size_t i = m_start; i < m_end; i++)
+    {
+        Instruction const &instr = instructions[i];
+        if (instr.hasTarget && instr.target >= m_start && instr.target < m_end)
+        {
+            isBlockStart[instr.target - m_start] = true;
+        }
+        if (instr.hasTarget || instr.op == Operation::Return || instr.op == Operation::ReturnValue ||
+            instr.op == Operation::TailCallLocal || instr.op == Operation::End)
+        {
+            isBlockStart[i + 1 - m_start] = true;
+        }
+    }
+    m_blockOf.assign(m_end - m_start, 0);
+    for (size_t i = m_start; i < m_end; i++)
+    {
+        if (isBlockStart[i - m_start])
+        {
+            m_blocks.push_back(BasicBlock{.start = i, .end = i + 1, .isReachable = m_states[i - m_start].isReachable, .successors = {}, .predecessors = {}});
+        }
+        m_blocks.back().end = i + 1;
+        m_blockOf[i - m_start] = m_blocks.size() - 1;
+    }
+    for (size_t i = 0; i < m_blocks.size(); i++)
+    {
+        Instruction const &last = instructions[m_blocks[i].end - 1];
+        std::vector<size_t> next;
+        if (last.hasTarget && last.target >= m_start && last.target < m_end)
+        {
+            next.push_back(last.target);
+        }
+        if (last.op != Operation::Jump && last.op != Operation::Return && last.op != Operation::ReturnValue &&
+            last.op != Operation::TailCallLocal && last.op != Operation::End && m_blocks[i].end < m_end)
+        {
+            next.push_back(m_blocks[i].end);
+        }
+        for (std::vector<size_t>::const_iterator it = next.begin(); it != next.end(); it++)
+        {
+            size_t block = getBlockOf(*it);
+            if (std::find(m_blocks[i].successors.begin(), m_blocks[i].successors.end(), block) == m_blocks[i].successors.end())
+            {
+                m_blocks[i].successors.push_back(block);
+                m_blocks[block].predecessors.push_back(i);
+            }
+        }
+    }
+
+    // definitions are propagated along the edges until nothing changes
+    m_blockDefinitions.assign(m_blocks.size(), {});
+    for (size_t i = 0; i < argCount; i++)
+    {
+        m_blockDefinitions[0][(uint8_t)i].insert(EntryDefinition);
+    }
+    std::vector<bool> isVisited(m_blocks.size(), false);
+    std::vector<size_t> pending = {0};
+    while (!pending.empty())
+    {
+        size_t block = pending.back();
+        pending.pop_back();
+        isVisited[block] = true;
+        std::map<uint8_t, std::set<size_t>> definitions = m_blockDefinitions[block];
+        for (size_t i = m_blocks[block].start; i < m_blocks[block].end; i++)
+        {
+            _applyDefinitions(i, definitions);
+        }
+        for (std::vector<size_t>::const_iterator it = m_blocks[block].successors.begin(); it != m_blocks[block].successors.end(); it++)
+        {
+            bool changed = false;
+            std::map<uint8_t, std::set<size_t>> &target = m_blockDefinitions[*it];
+            for (std::map<uint8_t, std::set<size_t>>::const_iterator defIt = definitions.begin(); defIt != definitions.end(); defIt++)
+            {
+                std::set<size_t> &targetDefs = target[defIt->first];
+                size_t oldSize = targetDefs.size();
+                targetDefs.insert(defIt->second.begin(), defIt->second.end());
+                changed |= targetDefs.size() != oldSize;
+            }
+            if ((changed || !isVisited[*it]) && std::find(pending.begin(), pending.end(), *it) == pending.end())
+            {
+                pending.push_back(*it);
+            }
+        }
+    }
+    return true;
+}
+
+std::set<size_t> GobLang::Compiler::ControlFlowGraph::getReachingDefinitions(size_t index, uint8_t id) const
+{
+    size_t block = getBlockOf(index);
+    std::map<uint8_t, std::set<size_t>> definitions;
+    std::map<uint8_t, std::set<size_t>>::const_iterator blockIt = m_blockDefinitions[block].find(id);
+    if (blockIt != m_blockDefinitions[block].end())
+    {
+        definitions[id] = blockIt->second;
+    }
+    for (size_t i = m_blocks[block].start; i < index; i++)
+    {
+        _applyDefinitions(i, definitions);
+    }
+    return definitions[id];
+}
+
+std::vector<size_t> GobLang::Compiler::ControlFlowGraph::getUses(size_t definition, uint8_t id) const
+{
+    std::vector<size_t> uses;
+    for (std::vector<BasicBlock>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); it++)
+    {
+        if (!it->isReachable)
+        {
+            continue;
+        }
+        std::map<uint8_t, std::set<size_t>> definitions;
+        std::map<uint8_t, std::set<size_t>>::const_iterator blockIt = m_blockDefinitions[it - m_blocks.begin()].find(id);
+        if (blockIt != m_blockDefinitions[it - m_blocks.begin()].end())
+        {
+            definitions[id] = blockIt->second;
+        }
+        for (size_t i = it->start; i < it->end; i++)
+        {
+            if (readsLocal((*m_instructions)[i], id) && definitions[id].count(definition) > 0)
+            {
+                uses.push_back(i);
+            }
+            _applyDefinitions(i, definitions);
+        }
+    }
+    return uses;
+}
+
+std::vector<uint8_t> GobLang::Compiler::ControlFlowGraph::getDefinedLocals(Instruction const &instr, size_t localCount)
+{
+    std::vector<uint8_t> locals;
+    switch (instr.op)
+    {
+    case Operation::SetLocal:
+    case Operation::SetLocalKeep:
+        // assigning a variable after the last one creates every variable in between
+        for (size_t i = localCount; i < instr.args[0]; i++)
+        {
+            locals.push_back((uint8_t)i);
+        }
+        locals.push_back(instr.args[0]);
+        break;
+    case Operation::IncrementLocal:
+    case Operation::OperateLocal:
+        locals.push_back(instr.args[0]);
+        break;
+    case Operation::ShrinkLocal:
+        for (size_t i = localCount - std::min(localCount, (size_t)instr.args[0]); i < localCount; i++)
+        {
+            locals.push_back((uint8_t)i);
+        }
+        break;
+    default:
+        break;
+    }
+    return locals;
+}
+
+bool GobLang::Compiler::ControlFlowGraph::readsLocal(Instruction const &instr, uint8_t id)
+{
+    switch (instr.op)
+    {
+    case Operation::SetLocal:
+    case Operation::SetLocalKeep:
+        return false;
+    default:
+    {
+        std::vector<size_t> localArgs = getLocalArguments(instr.op);
+        return std::find_if(localArgs.begin(), localArgs.end(), [&instr, id](size_t arg)
+                            { return instr.args[arg] == id; }) != localArgs.end();
+    }
+    }
+}
+
+void GobLang::Compiler::ControlFlowGraph::_applyDefinitions(size_t index, std::map<uint8_t, std::set<size_t>> &definitions) const
+{
+    std::vector<uint8_t> locals = getDefinedLocals((*m_instructions)[index], m_states[index - m_start].localCount);
+    for (std::vector<uint8_t>::const_iterator it = locals.begin(); it != locals.end(); it++)
+    {
+        definitions[*it] = {index};
+    }
+}
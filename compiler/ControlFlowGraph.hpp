@@ -0,0 +1,136 @@
+#pragma once
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
+#include "InstructionList.hpp"
+namespace GobLang::Compiler
+{
+    /**
+     * @brief Sequence of instructions that is always executed from the first to the last one
+     *
+     */
+    struct BasicBlock
+    {
+        /**
+         * @brief Index of the first instruction of the block
+         *
+         */
+        size_t start;
+        /**
+         * @brief Index after the last instruction of the block
+         *
+         */
+        size_t end;
+        bool isReachable = false;
+        /**
+         * @brief Ids of blocks that can be executed right after this block
+         *
+         */
+        std::vector<size_t> successors;
+        /**
+         * @brief Ids of blocks that can be executed right before this block
+         *
+         */
+        std::vector<size_t> predecessors;
+    };
+
+    /**
+     * @brief Control flow graph of the main code or a single function built on top of the decoded instructions.
+     * Graph also tracks which assignments of local variables can reach every instruction,
+     * which replaces phi nodes of SSA form: value of a variable comes from any of its reaching definitions.
+     * Graph refers to the instructions it was built from, so it has to be built again after instructions are inserted or removed
+     *
+     */
+    class ControlFlowGraph
+    {
+    public:
+        /**
+         * @brief Definition used for the values that local variables have when the code starts, like function arguments
+         *
+         */
+        static constexpr size_t EntryDefinition = SIZE_MAX;
+
+        /**
+         * @brief Build graph for the code starting at the given instruction
+         *
+         * @param code Decoded code
+         * @param start Index of the first instruction of the main code or function
+         * @param argCount Amount of arguments of the function
+         * @return true Graph was built
+         * @return false State of the frame could not be found, so variables can't be tracked
+         */
+        bool build(InstructionList const &code, size_t start, size_t argCount);
+
+        std::vector<BasicBlock> const &getBlocks() const { return m_blocks; }
+
+        /**
+         * @brief Get id of the block that contains the instruction
+         *
+         */
+        size_t getBlockOf(size_t index) const { return m_blockOf[index - m_start]; }
+
+        /**
+         * @brief State of the frame before each instruction, indexed from the start of the code
+         *
+         */
+        std::vector<FrameState> const &getStates() const { return m_states; }
+
+        size_t getStart() const { return m_start; }
+
+        size_t getEnd() const { return m_end; }
+
+        /**
+         * @brief Get instructions that could have assigned the value the local variable has before the given instruction.
+         * Besides assignments, definitions include instructions that free the variable or create it as null when a variable with higher id is assigned,
+         * and `EntryDefinition` for arguments
+         *
+         * @param index Index of the instruction
+         * @param id Id of the local variable
+         * @return std::set<size_t> Indices of defining instructions
+         */
+        std::set<size_t> getReachingDefinitions(size_t index, uint8_t id) const;
+
+        /**
+         * @brief Get instructions that read the value assigned to the local variable by the definition
+         *
+         * @param definition Index of the defining instruction or `EntryDefinition`
+         * @param id Id of the local variable
+         * @return std::vector<size_t> Indices of instructions that use the value
+         */
+        std::vector<size_t> getUses(size_t definition, uint8_t id) const;
+
+        /**
+         * @brief Get ids of local variables that are assigned by the instruction
+         *
+         * @param instr Instruction to check
+         * @param localCount Amount of local variables before the instruction
+         */
+        static std::vector<uint8_t> getDefinedLocals(Instruction const &instr, size_t localCount);
+
+        /**
+         * @brief Check if the instruction reads value of the local variable
+         *
+         */
+        static bool readsLocal(Instruction const &instr, uint8_t id);
+
+    private:
+        /**
+         * @brief Apply definitions made by the instruction to the set of reaching definitions
+         *
+         */
+        void _applyDefinitions(size_t index, std::map<uint8_t, std::set<size_t>> &definitions) const;
+
+        std::vector<Instruction> const *m_instructions = nullptr;
+        size_t m_start = 0;
+        size_t m_end = 0;
+        std::vector<BasicBlock> m_blocks;
+        std::vector<size_t> m_blockOf;
+        std::vector<FrameState> m_states;
+        /**
+         * @brief Definitions of local variables that reach the start of each block
+         *
+         */
+        std::vector<std::map<uint8_t, std::set<size_t>>> m_blockDefinitions;
+    };
+}
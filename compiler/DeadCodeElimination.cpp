@@ -0,0 +1,183 @@
+#include "DeadCodeElimination.hpp"
+#include <algorithm>
+
+void GobLang::Compiler::DeadCodeElimination::optimize()
+{
+    if (!m_code.decode(m_byteCode))
+    {
+        return;
+    }
+    std::vector<Instruction> &instructions = m_code.getInstructions();
+    std::vector<size_t> &starts = m_code.getFunctionStarts();
+    if (std::find(starts.begin(), starts.end(), 0) != starts.end())
+    {
+        return;
+    }
+    bool changed = _foldConstantBranches();
+    size_t funcCount = starts.size();
+    // code regions use the id equal to function count for the main code
+    std::vector<size_t> regionStarts = starts;
+    regionStarts.push_back(0);
+    std::vector<size_t> regionEnds;
+    for (std::vector<size_t>::const_iterator it = regionStarts.begin(); it != regionStarts.end(); it++)
+    {
+        regionEnds.push_back(m_code.getCodeEnd(*it));
+    }
+
+    std::vector<bool> isReachable(instructions.size(), false);
+    std::vector<bool> isAnalyzed(funcCount + 1, false);
+    std::vector<bool> isCalled(funcCount + 1, false);
+    isCalled[funcCount] = true;
+    std::vector<size_t> pending = {funcCount};
+    while (!pending.empty())
+    {
+        size_t region = pending.back();
+        pending.pop_back();
+        size_t start = regionStarts[region];
+        size_t end = regionEnds[region];
+        isAnalyzed[region] = _findReachable(start, end, isReachable);
+        for (size_t i = start; i < end; i++)
+        {
+            Instruction const &instr = instructions[i];
+            // if paths could not be followed every call is treated as possible
+            if ((isReachable[i] || !isAnalyzed[region]) && !instr.removed &&
+                (instr.op == Operation::CallLocal || instr.op == Operation::TailCallLocal) &&
+                instr.args[0] < funcCount && !isCalled[instr.args[0]])
+            {
+                isCalled[instr.args[0]] = true;
+                pending.push_back(instr.args[0]);
+            }
+        }
+    }
+
+    std::vector<size_t> newIds(funcCount, 0);
+    size_t newId = 0;
+    for (size_t i = 0; i <= funcCount; i++)
+    {
+        if (i < funcCount)
+        {
+            newIds[i] = newId;
+            newId += isCalled[i] ? 1 : 0;
+        }
+        if (isCalled[i] && !isAnalyzed[i])
+        {
+            continue;
+        }
+        for (size_t j = regionStarts[i]; j < regionEnds[i]; j++)
+        {
+            if (!isReachable[j] && !instructions[j].removed)
+            {
+                instructions[j].removed = true;
+                changed = true;
+            }
+        }
+    }
+    if (!changed)
+    {
+        return;
+    }
+    // removing code often leaves jumps that lead to the next remaining instruction
+    for (size_t i = 0; i < instructions.size(); i++)
+    {
+        Instruction &instr = instructions[i];
+        if (!instr.removed && instr.op == Operation::Jump && m_code.resolve(instr.target) == m_code.resolve(i + 1))
+        {
+            instr.removed = true;
+        }
+    }
+    for (std::vector<Instruction>::iterator it = instructions.begin(); it != instructions.end(); it++)
+    {
+        if (!it->removed && (it->op == Operation::CallLocal || it->op == Operation::TailCallLocal) && it->args[0] < funcCount)
+        {
+            it->args[0] = (uint8_t)newIds[it->args[0]];
+        }
+    }
+    // functions are removed from the end, so indices of functions that weren't processed yet stay the same
+    for (size_t i = funcCount; i > 0; i--)
+    {
+        if (!isCalled[i - 1])
+        {
+            m_byteCode.functions.erase(m_byteCode.functions.begin() + (i - 1));
+            starts.erase(starts.begin() + (i - 1));
+        }
+    }
+    m_code.encode(m_byteCode);
+}
+
+bool GobLang::Compiler::DeadCodeElimination::_foldConstantBranches()
+{
+    std::vector<Instruction> &instructions = m_code.getInstructions();
+    std::vector<bool> isJumpTarget = m_code.getJumpTargets();
+    std::vector<size_t> const &starts = m_code.getFunctionStarts();
+    bool changed = false;
+    for (size_t i = 1; i < instructions.size(); i++)
+    {
+        Instruction &branch = instructions[i];
+        Instruction &value = instructions[i - 1];
+        if ((branch.op != Operation::JumpIfNot && branch.op != Operation::JumpIf) ||
+            (value.op != Operation::PushTrue && value.op != Operation::PushFalse))
+        {
+            continue;
+        }
+        // other paths could reach the jump with a different value
+        if (isJumpTarget[i] || std::find(starts.begin(), starts.end(), i) != starts.end())
+        {
+            continue;
+        }
+        // jumps to the removed constant lead to the next instruction, which does the same thing without the constant
+        value.removed = true;
+        if ((branch.op == Operation::JumpIf) == (value.op == Operation::PushTrue))
+        {
+            branch.op = Operation::Jump;
+        }
+        else
+        {
+            branch.removed = true;
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+bool GobLang::Compiler::DeadCodeElimination::_findReachable(size_t start, size_t end, std::vector<bool> &isReachable) const
+{
+    std::vector<Instruction> const &instructions = m_code.getInstructions();
+    std::vector<size_t> pending = {start};
+    while (!pending.empty())
+    {
+        size_t index = pending.back();
+        pending.pop_back();
+        if (index < start || index >= end)
+        {
+            return false;
+        }
+        if (isReachable[index])
+        {
+            continue;
+        }
+        isReachable[index] = true;
+        Instruction const &instr = instructions[index];
+        if (instr.removed)
+        {
+            pending.push_back(index + 1);
+            continue;
+        }
+        if (instr.hasTarget)
+        {
+            pending.push_back(instr.target);
+        }
+        switch (instr.op)
+        {
+        case Operation::Jump:
+        case Operation::Return:
+        case Operation::ReturnValue:
+        case Operation::TailCallLocal:
+        case Operation::End:
+            break;
+        default:
+            pending.push_back(index + 1);
+            break;
+        }
+    }
+    return true;
+}
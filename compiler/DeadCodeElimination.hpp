@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "ByteCode.hpp"
+#include "InstructionList.hpp"
+namespace GobLang::Compiler
+{
+    /**
+     * @brief Pass that removes code which can never be executed.
+     * Functions that can't be called from the main code are removed and ids of the remaining functions are updated,
+     * while inside of the remaining code branches with constant conditions are replaced by jumps and instructions that can't be reached are removed
+     *
+     */
+    class DeadCodeElimination
+    {
+    public:
+        explicit DeadCodeElimination(ByteCode const &code) : m_byteCode(code) {}
+
+        /**
+         * @brief Remove unreachable code and functions and write the new code into the byte code
+         *
+         */
+        void optimize();
+
+        ByteCode getByteCode() const { return m_byteCode; }
+
+    private:
+        /**
+         * @brief Replace conditional jumps that use a constant pushed right before them with either a jump or nothing
+         *
+         * @return true Code was changed
+         */
+        bool _foldConstantBranches();
+
+        /**
+         * @brief Mark every instruction of the main code or function that can be executed
+         *
+         * @param start Index of the first instruction
+         * @param end Index after the last instruction
+         * @param isReachable Where to mark reachable instructions
+         * @return true Every path stays inside of the code
+         * @return false Code jumps outside or runs past the end, so it can't be changed
+         */
+        bool _findReachable(size_t start, size_t end, std::vector<bool> &isReachable) const;
+
+        ByteCode m_byteCode;
+        InstructionList m_code;
+    };
+}
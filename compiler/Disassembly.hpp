@@ -30,51 +30,82 @@ namespace GobLang::Compiler
             if (opIt != Operations.end())
             {
                 std::cout << std::hex << address << std::dec << ": " << (opIt->text) << " ";
-                switch (opIt->argType)
+                for (std::vector<OperatorArgType>::const_iterator argIt = opIt->args.begin(); argIt != opIt->args.end(); argIt++)
                 {
-                case OperatorArgType::Char:
-                    it++;
-                    address++;
-                    std::cout << '\'' << (char)(*it) << '\'';
+                    if (argIt != opIt->args.begin())
+                    {
+                        std::cout << " ";
+                    }
+                    switch (*argIt)
+                    {
+                    case OperatorArgType::Char:
+                        it++;
+                        address++;
+                        std::cout << '\'' << (char)(*it) << '\'';
+                        break;
+                    case OperatorArgType::Byte:
+                        it++;
+                        address++;
+                        std::cout << std::to_string(*it);
+                        break;
+                    case OperatorArgType::Operation:
+                    {
+                        it++;
+                        address++;
+                        std::vector<OperationData>::const_iterator argOpIt = std::find_if(
+                            Operations.begin(),
+                            Operations.end(),
+                            [it](OperationData const &a)
+                            {
+                                return (uint8_t)a.op == *it;
+                            });
+                        std::cout << (argOpIt != Operations.end() ? argOpIt->text : "?");
+                    }
                     break;
-                case OperatorArgType::Byte:
-                    it++;
-                    address++;
-                    std::cout << std::to_string(*it);
+                    case OperatorArgType::Float:
+                    {
+                        float val = parseBytesIntoValue<float>(it + 1, bytecode.end());
+                        it += sizeof(float);
+                        address += sizeof(float);
+                        std::cout << val;
+                    }
                     break;
-                case OperatorArgType::Float:
-                {
-                    float val = parseBytesIntoValue<float>(it + 1, bytecode.end());
-                    it += sizeof(float);
-                    address += sizeof(float);
-                    std::cout << val;
-                }
-                break;
-                case OperatorArgType::Int:
-                {
-                    int32_t val = parseBytesIntoValue<int32_t>(it + 1, bytecode.end());
-                    it += sizeof(int32_t);
-                    address += sizeof(int32_t);
-                    std::cout << val;
-                }
-                break;
-                case OperatorArgType::Address:
-                {
-                    ProgramAddressType val = parseBytesIntoValue<ProgramAddressType>(it + 1, bytecode.end());
-                    it += sizeof(ProgramAddressType);
-                    address += sizeof(ProgramAddressType);
-                    std::cout << std::hex << val << std::dec;
-                }
-                case OperatorArgType::UnsignedInt:
-                {
-                    uint32_t val = parseBytesIntoValue<uint32_t>(it + 1, bytecode.end());
-                    it += sizeof(uint32_t);
-                    address += sizeof(uint32_t);
-                    std::cout << val;
-                }
-                break;
-                default:
+                    case OperatorArgType::Int:
+                    {
+                        int32_t val = parseBytesIntoValue<int32_t>(it + 1, bytecode.end());
+                        it += sizeof(int32_t);
+                        address += sizeof(int32_t);
+                        std::cout << val;
+                    }
+                    break;
+                    case OperatorArgType::Address:
+                    {
+                        ProgramAddressType val = parseBytesIntoValue<ProgramAddressType>(it + 1, bytecode.end());
+                        it += sizeof(ProgramAddressType);
+                        address += sizeof(ProgramAddressType);
+                        std::cout << std::hex << val << std::dec;
+                    }
+                    break;
+                    case OperatorArgType::RelativeAddress:
+                    {
+                        ProgramAddressType val = parseBytesIntoValue<ProgramAddressType>(it + 1, bytecode.end());
+                        it += sizeof(ProgramAddressType);
+                        address += sizeof(ProgramAddressType);
+                        // distance is counted from the start of the next operation
+                        std::cout << std::hex << address + 1 + val << std::dec;
+                    }
+                    break;
+                    case OperatorArgType::UnsignedInt:
+                    {
+                        uint32_t val = parseBytesIntoValue<uint32_t>(it + 1, bytecode.end());
+                        it += sizeof(uint32_t);
+                        address += sizeof(uint32_t);
+                        std::cout << val;
+                    }
                     break;
+                    default:
+                        break;
+                    }
                 }
                 address++;
                 std::cout << std::endl;
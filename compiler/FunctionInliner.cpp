@@ -0,0 +1,175 @@
+#include "FunctionInliner.hpp"
+#include <algorithm>
+
+void GobLang::Compiler::FunctionInliner::optimize()
+{
+    if (!m_code.decode(m_byteCode))
+    {
+        return;
+    }
+    std::vector<InlineBody> bodies;
+    bool hasInlinable = false;
+    for (size_t i = 0; i < m_byteCode.functions.size(); i++)
+    {
+        bodies.push_back(_createBody(i));
+        hasInlinable |= bodies.back().canInline;
+    }
+    if (!hasInlinable)
+    {
+        return;
+    }
+
+    std::vector<CodeRegion> callers = m_code.getCodeRegions(m_byteCode);
+    // callers are processed from the end of the code, so inserting instructions doesn't move code that wasn't processed yet
+    for (std::vector<CodeRegion>::const_reverse_iterator it = callers.rbegin(); it != callers.rend(); it++)
+    {
+        size_t start = it->start;
+        size_t end = m_code.getCodeEnd(start);
+        std::vector<FrameState> states;
+        if (!m_code.findFrameStates(start, end, it->argCount, false, states))
+        {
+            continue;
+        }
+        for (size_t i = end; i > start; i--)
+        {
+            Instruction const &instr = m_code.getInstructions()[i - 1];
+            FrameState const &state = states[i - 1 - start];
+            if ((instr.op != Operation::CallLocal && instr.op != Operation::TailCallLocal) || !state.isReachable)
+            {
+                continue;
+            }
+            size_t funcId = instr.args[0];
+            if (funcId == it->funcId || funcId >= bodies.size() || !bodies[funcId].canInline)
+            {
+                continue;
+            }
+            // local variable ids are stored as a single byte
+            if (state.localCount + bodies[funcId].localCount > UINT8_MAX + 1)
+            {
+                continue;
+            }
+            m_code.replace(i - 1, _generateInlinedCall(bodies[funcId], state.localCount, instr.op == Operation::TailCallLocal));
+        }
+    }
+    m_code.encode(m_byteCode);
+}
+
+GobLang::Compiler::FunctionInliner::InlineBody GobLang::Compiler::FunctionInliner::_createBody(size_t funcId) const
+{
+    InlineBody body;
+    body.argCount = m_byteCode.functions[funcId].arguments.size();
+    size_t start = m_code.getFunctionStarts()[funcId];
+    size_t end = m_code.getCodeEnd(start);
+    std::vector<FrameState> states;
+    if (!m_code.findFrameStates(start, end, body.argCount, true, states))
+    {
+        return body;
+    }
+    std::vector<Instruction> const &instructions = m_code.getInstructions();
+    std::vector<size_t> bodyIndices(end - start, 0);
+    std::vector<size_t> reachable;
+    bool hasReturn = false;
+    bool hasReturnValue = false;
+    body.localCount = body.argCount;
+    for (size_t i = start; i < end; i++)
+    {
+        FrameState const &state = states[i - start];
+        if (!state.isReachable)
+        {
+            continue;
+        }
+        Operation op = instructions[i].op;
+        // return values are left on the stack of the caller, so there must be nothing else on the stack of the function
+        if ((op == Operation::Return && state.stackSize != 0) || (op == Operation::ReturnValue && state.stackSize != 1))
+        {
+            return body;
+        }
+        hasReturn |= op == Operation::Return;
+        hasReturnValue |= op == Operation::ReturnValue;
+        std::vector<size_t> localArgs = getLocalArguments(op);
+        for (std::vector<size_t>::const_iterator it = localArgs.begin(); it != localArgs.end(); it++)
+        {
+            body.localCount = std::max(body.localCount, (size_t)instructions[i].args[*it] + 1);
+        }
+        bodyIndices[i - start] = reachable.size();
+        reachable.push_back(i);
+    }
+    // code that calls the function expects either always getting a value or never getting it
+    if (reachable.size() > MaxInlinedInstructions || hasReturn == hasReturnValue)
+    {
+        return body;
+    }
+    for (std::vector<size_t>::const_iterator it = reachable.begin(); it != reachable.end(); it++)
+    {
+        Instruction instr = instructions[*it];
+        if (instr.hasTarget)
+        {
+            instr.target = bodyIndices[instr.target - start];
+        }
+        body.instructions.push_back(instr);
+        body.localCounts.push_back(states[*it - start].localCount);
+    }
+    body.returnsValue = hasReturnValue;
+    body.canInline = true;
+    return body;
+}
+
+std::vector<GobLang::Compiler::Instruction> GobLang::Compiler::FunctionInliner::_generateInlinedCall(InlineBody const &body, size_t base, bool isTailCall) const
+{
+    std::vector<Instruction> const &instructions = body.instructions;
+    // returns are replaced by freeing local variables of the function and jumping to the end, which is not needed for the last operation
+    std::vector<size_t> positions;
+    size_t position = body.argCount;
+    for (size_t i = 0; i < instructions.size(); i++)
+    {
+        positions.push_back(position);
+        Operation op = instructions[i].op;
+        if (op == Operation::Return || op == Operation::ReturnValue)
+        {
+            position += (body.localCounts[i] > 0 ? 1 : 0) + (i + 1 < instructions.size() ? 1 : 0);
+        }
+        else
+        {
+            position++;
+        }
+    }
+    size_t endPosition = position;
+
+    std::vector<Instruction> out;
+    // arguments are on the stack in the order they were passed, so last argument is on the top
+    for (size_t i = body.argCount; i > 0; i--)
+    {
+        out.push_back(Instruction{.op = Operation::SetLocal, .args = {(uint8_t)(base + i - 1)}});
+    }
+    for (size_t i = 0; i < instructions.size(); i++)
+    {
+        Instruction instr = instructions[i];
+        if (instr.op == Operation::Return || instr.op == Operation::ReturnValue)
+        {
+            if (body.localCounts[i] > 0)
+            {
+                out.push_back(Instruction{.op = Operation::ShrinkLocal, .args = {(uint8_t)body.localCounts[i]}});
+            }
+            if (i + 1 < instructions.size())
+            {
+                out.push_back(Instruction{.op = Operation::Jump, .args = {}, .hasTarget = true, .target = endPosition});
+            }
+            continue;
+        }
+        std::vector<size_t> localArgs = getLocalArguments(instr.op);
+        for (std::vector<size_t>::const_iterator it = localArgs.begin(); it != localArgs.end(); it++)
+        {
+            instr.args[*it] = (uint8_t)(instr.args[*it] + base);
+        }
+        if (instr.hasTarget)
+        {
+            instr.target = positions[instr.target];
+        }
+        out.push_back(instr);
+    }
+    if (isTailCall)
+    {
+        out.push_back(Instruction{.op = body.returnsValue ? Operation::ReturnValue : Operation::Return, .args = {}});
+    }
+    return out;
+}
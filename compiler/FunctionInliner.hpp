@@ -0,0 +1,78 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "ByteCode.hpp"
+#include "InstructionList.hpp"
+namespace GobLang::Compiler
+{
+    /**
+     * @brief Pass that replaces calls to small functions with the code of the function.
+     * Arguments and local variables of the inlined function are moved to the local variables that come after the variables of the caller
+     *
+     */
+    class FunctionInliner
+    {
+    public:
+        /**
+         * @brief Max amount of reachable operations in function that can be inlined
+         *
+         */
+        static constexpr size_t MaxInlinedInstructions = 24;
+
+        explicit FunctionInliner(ByteCode const &code) : m_byteCode(code) {}
+
+        /**
+         * @brief Inline calls to all suitable functions and write the new code into the byte code
+         *
+         */
+        void optimize();
+
+        ByteCode getByteCode() const { return m_byteCode; }
+
+    private:
+        /**
+         * @brief Code of a function prepared for inlining
+         *
+         */
+        struct InlineBody
+        {
+            bool canInline = false;
+            bool returnsValue = false;
+            size_t argCount = 0;
+            /**
+             * @brief Highest amount of local variables the function can have at once
+             *
+             */
+            size_t localCount = 0;
+            /**
+             * @brief Reachable instructions of the function. Jump targets are indices in this list
+             *
+             */
+            std::vector<Instruction> instructions;
+            /**
+             * @brief Amount of local variables before each instruction
+             *
+             */
+            std::vector<size_t> localCounts;
+        };
+
+        /**
+         * @brief Check if function can be inlined and collect its code
+         *
+         */
+        InlineBody _createBody(size_t funcId) const;
+
+        /**
+         * @brief Generate code that replaces a call to the function
+         *
+         * @param body Function to inline
+         * @param base Amount of local variables of the caller, which is used as offset for local variables of the function
+         * @param isTailCall If true code will return from the caller after the function ends
+         * @return std::vector<Instruction> Instructions with jump targets relative to the first instruction
+         */
+        std::vector<Instruction> _generateInlinedCall(InlineBody const &body, size_t base, bool isTailCall) const;
+
+        ByteCode m_byteCode;
+        InstructionList m_code;
+    };
+}
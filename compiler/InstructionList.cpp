@@ -0,0 +1,486 @@
+#include "InstructionList.hpp"
+#include <algorithm>
+
+std::vector<size_t> GobLang::Compiler::getLocalArguments(Operation op)
+{
+    switch (op)
+    {
+    case Operation::GetLocal:
+    case Operation::SetLocal:
+    case Operation::SetLocalKeep:
+    case Operation::IncrementLocal:
+    case Operation::JumpIfNotCompareLocalConst:
+    case Operation::GetArrayLocal:
+    case Operation::GetArrayLocalUnchecked:
+    case Operation::OperateLocal:
+        return {0};
+    case Operation::JumpIfNotCompareLocals:
+        return {0, 1};
+    default:
+        return {};
+    }
+}
+
+bool GobLang::Compiler::getStackEffect(Instruction const &instr, int32_t &effect)
+{
+    switch (instr.op)
+    {
+    case Operation::PushConstInt:
+    case Operation::PushConstUnsignedInt:
+    case Operation::PushConstFloat:
+    case Operation::PushConstChar:
+    case Operation::PushConstString:
+    case Operation::PushTrue:
+    case Operation::PushFalse:
+    case Operation::PushNull:
+    case Operation::GetLocal:
+    case Operation::GetGlobal:
+        effect = 1;
+        return true;
+    case Operation::None:
+    case Operation::Not:
+    case Operation::Negate:
+    case Operation::BitNot:
+    case Operation::GetArrayLocal:
+    case Operation::GetArrayLocalUnchecked:
+    case Operation::SetLocalKeep:
+    case Operation::IncrementLocal:
+    case Operation::Jump:
+    case Operation::JumpIfNotCompareLocals:
+    case Operation::JumpIfNotCompareLocalConst:
+    case Operation::ShrinkLocal:
+    case Operation::Return:
+    case Operation::CheckBool:
+        effect = 0;
+        return true;
+    case Operation::Add:
+    case Operation::Sub:
+    case Operation::Mul:
+    case Operation::Div:
+    case Operation::Modulo:
+    case Operation::BitAnd:
+    case Operation::BitOr:
+    case Operation::BitXor:
+    case Operation::ShiftLeft:
+    case Operation::ShiftRight:
+    case Operation::Equals:
+    case Operation::NotEq:
+    case Operation::Less:
+    case Operation::More:
+    case Operation::LessOrEq:
+    case Operation::MoreOrEq:
+    case Operation::And:
+    case Operation::Or:
+    case Operation::AddInt:
+    case Operation::SubInt:
+    case Operation::MulInt:
+    case Operation::DivInt:
+    case Operation::AddFloat:
+    case Operation::SubFloat:
+    case Operation::MulFloat:
+    case Operation::DivFloat:
+    case Operation::LessInt:
+    case Operation::MoreInt:
+    case Operation::LessOrEqInt:
+    case Operation::MoreOrEqInt:
+    case Operation::LessFloat:
+    case Operation::MoreFloat:
+    case Operation::LessOrEqFloat:
+    case Operation::MoreOrEqFloat:
+    case Operation::GetArray:
+    case Operation::GetArrayUnchecked:
+    case Operation::SetLocal:
+    case Operation::SetGlobal:
+    case Operation::OperateLocal:
+    case Operation::OperateGlobal:
+    case Operation::JumpIfNot:
+    case Operation::JumpIf:
+    case Operation::JumpIfNotOrPop:
+    case Operation::JumpIfOrPop:
+    case Operation::ReturnValue:
+        effect = -1;
+        return true;
+    case Operation::SetArray:
+    case Operation::SetArrayUnchecked:
+    case Operation::OperateArray:
+        effect = -3;
+        return true;
+    case Operation::CreateArray:
+        effect = 1 - (int32_t)instr.args[0];
+        return true;
+    default:
+        return false;
+    }
+}
+
+GobLang::Compiler::InstructionEffect GobLang::Compiler::getInstructionEffect(Instruction const &instr, ByteCode const &code)
+{
+    switch (instr.op)
+    {
+    case Operation::SetLocal:
+    case Operation::SetLocalKeep:
+    case Operation::IncrementLocal:
+    case Operation::OperateLocal:
+        return InstructionEffect::WritesLocal;
+    case Operation::SetGlobal:
+    case Operation::OperateGlobal:
+        return InstructionEffect::WritesGlobal;
+    case Operation::SetArray:
+    case Operation::SetArrayUnchecked:
+    case Operation::OperateArray:
+        return InstructionEffect::WritesArrays;
+    case Operation::CallNative:
+        if (instr.args[0] >= code.nativeEffects.size() || code.nativeEffects[instr.args[0]] == NativeFunctionEffect::Any)
+        {
+            return InstructionEffect::Unknown;
+        }
+        return InstructionEffect::None;
+    // target of 'Set' is only known at runtime and called functions can change anything
+    case Operation::Set:
+    case Operation::Call:
+    case Operation::CallLocal:
+    case Operation::TailCallLocal:
+        return InstructionEffect::Unknown;
+    default:
+        return InstructionEffect::None;
+    }
+}
+
+bool GobLang::Compiler::InstructionList::decode(ByteCode const &byteCode)
+{
+    m_instructions.clear();
+    m_functionStarts.clear();
+    std::vector<OperationData const *> operationTable(256, nullptr);
+    for (std::vector<OperationData>::const_iterator it = Operations.begin(); it != Operations.end(); it++)
+    {
+        operationTable[(uint8_t)it->op] = &(*it);
+    }
+    std::vector<uint8_t> const &code = byteCode.operations;
+    // index of the instruction starting at each address, addresses in the middle of an operation are not valid jump targets
+    std::vector<size_t> addressToIndex(code.size() + 1, SIZE_MAX);
+    size_t address = 0;
+    while (address < code.size())
+    {
+        OperationData const *data = operationTable[code[address]];
+        if (data == nullptr)
+        {
+            return false;
+        }
+        Instruction instr = Instruction{.op = data->op, .args = {}};
+        size_t argAddress = address + 1;
+        for (std::vector<OperatorArgType>::const_iterator it = data->args.begin(); it != data->args.end(); it++)
+        {
+            size_t argSize = getOperatorArgSize(*it);
+            if (argAddress + argSize > code.size())
+            {
+                return false;
+            }
+            if (*it == OperatorArgType::Address || *it == OperatorArgType::RelativeAddress)
+            {
+                // address is always written as the last argument when encoding
+                if (it + 1 != data->args.end())
+                {
+                    return false;
+                }
+                instr.hasTarget = true;
+                instr.target = 0;
+                for (size_t i = 0; i < argSize; i++)
+                {
+                    instr.target = (instr.target << 8) | code[argAddress + i];
+                }
+                if (*it == OperatorArgType::RelativeAddress)
+                {
+                    instr.relative = true;
+                    instr.target += argAddress + argSize;
+                }
+            }
+            else
+            {
+                instr.args.insert(instr.args.end(), code.begin() + argAddress, code.begin() + argAddress + argSize);
+            }
+            argAddress += argSize;
+        }
+        addressToIndex[address] = m_instructions.size();
+        m_instructions.push_back(instr);
+        address = argAddress;
+    }
+    addressToIndex[code.size()] = m_instructions.size();
+
+    for (std::vector<Instruction>::iterator it = m_instructions.begin(); it != m_instructions.end(); it++)
+    {
+        if (!it->hasTarget)
+        {
+            continue;
+        }
+        if (it->target >= addressToIndex.size() || addressToIndex[it->target] == SIZE_MAX)
+        {
+            return false;
+        }
+        it->target = addressToIndex[it->target];
+    }
+    for (std::vector<Function>::const_iterator it = byteCode.functions.begin(); it != byteCode.functions.end(); it++)
+    {
+        if (it->start >= addressToIndex.size() || addressToIndex[it->start] == SIZE_MAX)
+        {
+            return false;
+        }
+        m_functionStarts.push_back(addressToIndex[it->start]);
+    }
+    return true;
+}
+
+void GobLang::Compiler::InstructionList::encode(ByteCode &byteCode) const
+{
+    // removed instructions get the address of the next instruction which makes jumps to them land on the correct operation
+    std::vector<size_t> addresses(m_instructions.size() + 1);
+    size_t address = 0;
+    for (size_t i = 0; i < m_instructions.size(); i++)
+    {
+        addresses[i] = address;
+        Instruction const &instr = m_instructions[i];
+        if (!instr.removed)
+        {
+            address += 1 + instr.args.size() + (instr.hasTarget ? sizeof(size_t) : 0);
+        }
+    }
+    addresses[m_instructions.size()] = address;
+
+    std::vector<uint8_t> code;
+    code.reserve(address);
+    for (std::vector<Instruction>::const_iterator it = m_instructions.begin(); it != m_instructions.end(); it++)
+    {
+        if (it->removed)
+        {
+            continue;
+        }
+        code.push_back((uint8_t)it->op);
+        code.insert(code.end(), it->args.begin(), it->args.end());
+        if (it->hasTarget)
+        {
+            size_t target = addresses[it->target];
+            if (it->relative)
+            {
+                // distance is allowed to wrap around, since the machine adds it using the same unsigned type
+                target -= code.size() + sizeof(size_t);
+            }
+            for (int32_t i = sizeof(size_t) - 1; i >= 0; i--)
+            {
+                code.push_back((uint8_t)(target >> (i * 8)));
+            }
+        }
+    }
+    byteCode.operations = code;
+    for (size_t i = 0; i < byteCode.functions.size(); i++)
+    {
+        byteCode.functions[i].start = addresses[m_functionStarts[i]];
+    }
+}
+
+void GobLang::Compiler::InstructionList::replace(size_t index, std::vector<Instruction> const &instructions)
+{
+    replace(index, 1, instructions);
+}
+
+void GobLang::Compiler::InstructionList::replace(size_t index, size_t count, std::vector<Instruction> const &instructions)
+{
+    // every instruction after the replaced ones moves by the difference in size
+    size_t last = index + count - 1;
+    for (std::vector<Instruction>::iterator it = m_instructions.begin(); it != m_instructions.end(); it++)
+    {
+        if (it->hasTarget && it->target > last)
+        {
+            it->target = it->target - count + instructions.size();
+        }
+        else if (it->hasTarget && it->target > index)
+        {
+            it->target = index;
+        }
+    }
+    for (std::vector<size_t>::iterator it = m_functionStarts.begin(); it != m_functionStarts.end(); it++)
+    {
+        if (*it > last)
+        {
+            *it = *it - count + instructions.size();
+        }
+        else if (*it > index)
+        {
+            *it = index;
+        }
+    }
+    std::vector<Instruction> added = instructions;
+    for (std::vector<Instruction>::iterator it = added.begin(); it != added.end(); it++)
+    {
+        if (it->hasTarget)
+        {
+            it->target += index;
+        }
+    }
+    m_instructions.erase(m_instructions.begin() + index, m_instructions.begin() + index + count);
+    m_instructions.insert(m_instructions.begin() + index, added.begin(), added.end());
+}
+
+void GobLang::Compiler::InstructionList::insert(size_t index, std::vector<Instruction> const &instructions)
+{
+    size_t shift = instructions.size();
+    for (std::vector<Instruction>::iterator it = m_instructions.begin(); it != m_instructions.end(); it++)
+    {
+        if (it->hasTarget && it->target >= index)
+        {
+            it->target += shift;
+        }
+    }
+    for (std::vector<size_t>::iterator it = m_functionStarts.begin(); it != m_functionStarts.end(); it++)
+    {
+        if (*it >= index)
+        {
+            *it += shift;
+        }
+    }
+    std::vector<Instruction> added = instructions;
+    for (std::vector<Instruction>::iterator it = added.begin(); it != added.end(); it++)
+    {
+        if (it->hasTarget)
+        {
+            it->target += index;
+        }
+    }
+    m_instructions.insert(m_instructions.begin() + index, added.begin(), added.end());
+}
+
+size_t GobLang::Compiler::InstructionList::getCodeEnd(size_t start) const
+{
+    size_t end = m_instructions.size();
+    std::vector<size_t> const &starts = m_functionStarts;
+    for (std::vector<size_t>::const_iterator it = starts.begin(); it != starts.end(); it++)
+    {
+        if (*it > start && *it < end)
+        {
+            end = *it;
+        }
+    }
+    return end;
+}
+
+std::vector<GobLang::Compiler::CodeRegion> GobLang::Compiler::InstructionList::getCodeRegions(ByteCode const &code) const
+{
+    std::vector<CodeRegion> regions;
+    if (std::find(m_functionStarts.begin(), m_functionStarts.end(), 0) == m_functionStarts.end())
+    {
+        regions.push_back(CodeRegion{.start = 0, .argCount = 0, .funcId = code.functions.size()});
+    }
+    for (size_t i = 0; i < m_functionStarts.size(); i++)
+    {
+        regions.push_back(CodeRegion{.start = m_functionStarts[i], .argCount = code.functions[i].arguments.size(), .funcId = i});
+    }
+    std::sort(regions.begin(), regions.end(), [](CodeRegion const &a, CodeRegion const &b)
+              { return a.start < b.start; });
+    return regions;
+}
+
+std::vector<bool> GobLang::Compiler::InstructionList::getJumpTargets() const
+{
+    std::vector<bool> isJumpTarget(m_instructions.size() + 1, false);
+    for (std::vector<Instruction>::const_iterator it = m_instructions.begin(); it != m_instructions.end(); it++)
+    {
+        if (it->hasTarget)
+        {
+            isJumpTarget[it->target] = true;
+        }
+    }
+    return isJumpTarget;
+}
+
+bool GobLang::Compiler::InstructionList::findFrameStates(size_t start, size_t end, size_t argCount, bool trackStack, std::vector<FrameState> &states) const
+{
+    std::vector<Instruction> const &instructions = m_instructions;
+    states.assign(end - start, FrameState{});
+    if (start >= end)
+    {
+        return false;
+    }
+    states[0] = FrameState{.isReachable = true, .stackSize = 0, .localCount = argCount};
+    std::vector<size_t> pending = {start};
+    while (!pending.empty())
+    {
+        size_t index = pending.back();
+        pending.pop_back();
+        Instruction const &instr = instructions[index];
+        FrameState state = states[index - start];
+
+        int32_t effect = 0;
+        if (trackStack && !getStackEffect(instr, effect))
+        {
+            return false;
+        }
+        if (instr.op == Operation::SetLocal || instr.op == Operation::SetLocalKeep)
+        {
+            state.localCount = std::max(state.localCount, (size_t)instr.args[0] + 1);
+        }
+        else if (instr.op == Operation::ShrinkLocal)
+        {
+            if (instr.args[0] > state.localCount)
+            {
+                return false;
+            }
+            state.localCount -= instr.args[0];
+        }
+
+        std::vector<std::pair<size_t, int32_t>> next;
+        switch (instr.op)
+        {
+        case Operation::Return:
+        case Operation::ReturnValue:
+        case Operation::TailCallLocal:
+        case Operation::End:
+            break;
+        case Operation::Jump:
+            next.push_back({instr.target, state.stackSize});
+            break;
+        case Operation::JumpIfNotOrPop:
+        case Operation::JumpIfOrPop:
+            // value stays on the stack only if jump happens
+            next.push_back({instr.target, state.stackSize});
+            next.push_back({index + 1, state.stackSize + effect});
+            break;
+        default:
+            if (instr.hasTarget)
+            {
+                next.push_back({instr.target, state.stackSize + effect});
+            }
+            next.push_back({index + 1, state.stackSize + effect});
+            break;
+        }
+        for (std::vector<std::pair<size_t, int32_t>>::const_iterator it = next.begin(); it != next.end(); it++)
+        {
+            if (it->first < start || it->first >= end || it->second < 0)
+            {
+                return false;
+            }
+            FrameState &nextState = states[it->first - start];
+            if (!nextState.isReachable)
+            {
+                nextState = FrameState{.isReachable = true, .stackSize = it->second, .localCount = state.localCount};
+                pending.push_back(it->first);
+            }
+            else if (nextState.stackSize != it->second || nextState.localCount != state.localCount)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+size_t GobLang::Compiler::InstructionList::resolve(size_t index) const
+{
+    while (index < m_instructions.size() && m_instructions[index].removed)
+    {
+        index++;
+    }
+    return index;
+}
+
+size_t GobLang::Compiler::InstructionList::next(size_t index) const
+{
+    return resolve(index + 1);
+}
@@ -0,0 +1,246 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "ByteCode.hpp"
+#include "../execution/Operations.hpp"
+namespace GobLang::Compiler
+{
+    /**
+     * @brief Single decoded operation of the byte code. Jump addresses are replaced by index of the instruction they point to,
+     * which allows adding and removing instructions without breaking jumps
+     *
+     */
+    struct Instruction
+    {
+        Operation op;
+        /**
+         * @brief All argument bytes of the operation except for the jump address
+         *
+         */
+        std::vector<uint8_t> args;
+        /**
+         * @brief If true this operation ends with a jump address
+         *
+         */
+        bool hasTarget = false;
+        /**
+         * @brief Index of the instruction this operation jumps to. Index equal to the instruction count means end of the code
+         *
+         */
+        size_t target = 0;
+        /**
+         * @brief If true jump address is stored as distance from the end of the operation
+         *
+         */
+        bool relative = false;
+        /**
+         * @brief Removed instructions are skipped when generating byte code and jumps to them lead to the next instruction instead
+         *
+         */
+        bool removed = false;
+    };
+
+    /**
+     * @brief State of the function frame before executing an instruction
+     *
+     */
+    struct FrameState
+    {
+        bool isReachable = false;
+        /**
+         * @brief Amount of values on the operation stack of the function
+         *
+         */
+        int32_t stackSize = 0;
+        /**
+         * @brief Amount of local variables of the function
+         *
+         */
+        size_t localCount = 0;
+    };
+
+    /**
+     * @brief Main code or a single function, which is processed separately by the passes
+     *
+     */
+    struct CodeRegion
+    {
+        /**
+         * @brief Index of the first instruction
+         *
+         */
+        size_t start;
+        size_t argCount;
+        /**
+         * @brief Id of the function or amount of functions for the main code
+         *
+         */
+        size_t funcId;
+    };
+
+    /**
+     * @brief Existing values that an instruction can change
+     *
+     */
+    enum class InstructionEffect
+    {
+        None,
+        /**
+         * @brief Changes the local variable with the id stored in the first argument
+         *
+         */
+        WritesLocal,
+        /**
+         * @brief Changes the global variable with the slot stored in the first argument
+         *
+         */
+        WritesGlobal,
+        /**
+         * @brief Changes items of an array, but never its size
+         *
+         */
+        WritesArrays,
+        /**
+         * @brief Calls code that can change any variable, array item or size of an array
+         *
+         */
+        Unknown,
+    };
+
+    /**
+     * @brief Get positions of the argument bytes that store local variable ids
+     *
+     * @param op Operation to check
+     * @return std::vector<size_t> Indices into `Instruction::args`
+     */
+    std::vector<size_t> getLocalArguments(Operation op);
+
+    /**
+     * @brief Get how the operation changes the size of the operation stack.
+     * Conditional jumps that keep the value on the stack when jumping report the change when not jumping
+     *
+     * @param instr Instruction to check
+     * @param effect Where to write the difference between stack sizes after and before the operation
+     * @return true Operation has a known effect
+     * @return false Effect depends on the code outside of the instruction, like with function calls
+     */
+    bool getStackEffect(Instruction const &instr, int32_t &effect);
+
+    /**
+     * @brief Get which existing values the instruction can change. Native functions that are pure or read only never change existing values
+     *
+     * @param instr Instruction to check
+     * @param code Byte code the instruction belongs to, used to find effects of native functions
+     */
+    InstructionEffect getInstructionEffect(Instruction const &instr, ByteCode const &code);
+
+    /**
+     * @brief Byte code decoded into a list of instructions, which is used by passes that need to change the code after it was generated
+     *
+     */
+    class InstructionList
+    {
+    public:
+        /**
+         * @brief Decode byte code operations into instructions
+         *
+         * @param code Code to decode
+         * @return true Code was decoded
+         * @return false Code contains unknown operations or jumps into the middle of an operation and can't be changed
+         */
+        bool decode(ByteCode const &code);
+
+        /**
+         * @brief Write instructions back into the byte code, updating jump addresses and function start addresses
+         *
+         * @param code Byte code that was used for decoding
+         */
+        void encode(ByteCode &code) const;
+
+        /**
+         * @brief Replace instruction with a sequence of instructions. Jumps to the replaced instruction will lead to the first new instruction
+         *
+         * @param index Index of the instruction to replace
+         * @param instructions New instructions. Their jump targets are indices relative to the first new instruction
+         */
+        void replace(size_t index, std::vector<Instruction> const &instructions);
+
+        /**
+         * @brief Replace a sequence of instructions with other instructions. Jumps to any of the replaced instructions will lead to the first new instruction
+         *
+         * @param index Index of the first instruction to replace
+         * @param count Amount of instructions to replace
+         * @param instructions New instructions. Their jump targets are indices relative to the first new instruction
+         */
+        void replace(size_t index, size_t count, std::vector<Instruction> const &instructions);
+
+        /**
+         * @brief Insert instructions before the given instruction. Jumps to the instruction at the index keep leading to that instruction
+         *
+         * @param index Index of the instruction to insert before
+         * @param instructions New instructions. Their jump targets are indices relative to the first new instruction
+         */
+        void insert(size_t index, std::vector<Instruction> const &instructions);
+
+        /**
+         * @brief Get index of the instruction after the last instruction of the main code or function that starts at the given index
+         *
+         */
+        size_t getCodeEnd(size_t start) const;
+
+        /**
+         * @brief Get the main code and all functions ordered by the index of their first instruction.
+         * Main code is skipped if a function starts at the beginning of the code
+         *
+         * @param code Byte code that was used for decoding
+         */
+        std::vector<CodeRegion> getCodeRegions(ByteCode const &code) const;
+
+        /**
+         * @brief Find which instructions are targets of jumps. Result has an extra item for the end of the code
+         *
+         */
+        std::vector<bool> getJumpTargets() const;
+
+        /**
+         * @brief Find state of the frame before each instruction of the main code or a function
+         *
+         * @param start Index of the first instruction
+         * @param end Index after the last instruction
+         * @param argCount Amount of arguments of the function
+         * @param trackStack If true fail on operations with unknown effect on the operation stack
+         * @param states Where to write states, indexed from the start of the function
+         * @return true Every instruction is always reached with the same state and code never jumps outside of the function
+         * @return false State could not be found
+         */
+        bool findFrameStates(size_t start, size_t end, size_t argCount, bool trackStack, std::vector<FrameState> &states) const;
+
+        /**
+         * @brief Get index of the first instruction at or after the given index that was not removed
+         *
+         */
+        size_t resolve(size_t index) const;
+
+        /**
+         * @brief Get index of the next instruction after the given one that was not removed
+         *
+         */
+        size_t next(size_t index) const;
+
+        std::vector<Instruction> &getInstructions() { return m_instructions; }
+
+        std::vector<Instruction> const &getInstructions() const { return m_instructions; }
+
+        /**
+         * @brief Index of the first instruction of each function in the same order as functions in the byte code
+         *
+         */
+        std::vector<size_t> &getFunctionStarts() { return m_functionStarts; }
+
+        std::vector<size_t> const &getFunctionStarts() const { return m_functionStarts; }
+
+    private:
+        std::vector<Instruction> m_instructions;
+        std::vector<size_t> m_functionStarts;
+    };
+}
@@ -0,0 +1,280 @@
+#include "LoopInvariantCodeMotion.hpp"
+#include <algorithm>
+
+void GobLang::Compiler::LoopInvariantCodeMotion::optimize()
+{
+    if (!m_code.decode(m_byteCode))
+    {
+        return;
+    }
+    std::vector<CodeRegion> regions = m_code.getCodeRegions(m_byteCode);
+    // code is processed from the end, so inserting instructions doesn't move code that wasn't processed yet
+    bool changed = false;
+    for (std::vector<CodeRegion>::const_reverse_iterator it = regions.rbegin(); it != regions.rend(); it++)
+    {
+        bool loopChanged = true;
+        while (loopChanged)
+        {
+            loopChanged = false;
+            size_t start = it->start;
+            size_t end = m_code.getCodeEnd(start);
+            std::vector<FrameState> states;
+            if (!m_code.findFrameStates(start, end, it->argCount, false, states))
+            {
+                break;
+            }
+            // every loop ends with a jump back to the condition
+            for (size_t i = end; i > start; i--)
+            {
+                Instruction const &instr = m_code.getInstructions()[i - 1];
+                if (instr.op != Operation::Jump || instr.target < start || instr.target > i - 1)
+                {
+                    continue;
+                }
+                if (!states[instr.target - start].isReachable || !states[i - 1 - start].isReachable)
+                {
+                    continue;
+                }
+                if (_optimizeLoop(instr.target, i - 1, states[instr.target - start].localCount))
+                {
+                    // indices of all loops after the changed one are different now
+                    loopChanged = true;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+    if (changed)
+    {
+        m_code.encode(m_byteCode);
+    }
+}
+
+bool GobLang::Compiler::LoopInvariantCodeMotion::_optimizeLoop(size_t header, size_t back, size_t localCount)
+{
+    std::vector<Instruction> &instructions = m_code.getInstructions();
+    size_t exit = back + 1;
+    if (exit >= instructions.size())
+    {
+        return false;
+    }
+    // loop must be entered only through the condition and left only by jumping to the instruction right after it
+    size_t maxLocal = 0;
+    for (size_t i = 0; i < instructions.size(); i++)
+    {
+        Instruction const &instr = instructions[i];
+        bool isInside = i >= header && i <= back;
+        if (isInside)
+        {
+            std::vector<size_t> localArgs = getLocalArguments(instr.op);
+            for (std::vector<size_t>::const_iterator it = localArgs.begin(); it != localArgs.end(); it++)
+            {
+                maxLocal = std::max(maxLocal, (size_t)instr.args[*it] + 1);
+            }
+        }
+        if (!instr.hasTarget)
+        {
+            continue;
+        }
+        if (isInside && (instr.target < header || instr.target > exit))
+        {
+            return false;
+        }
+        if (!isInside && instr.target > header && instr.target <= back)
+        {
+            return false;
+        }
+    }
+    std::vector<StackValue> values = _findInvariantValues(header, back, localCount);
+    size_t count = values.size();
+    // local variable ids are stored as a single byte
+    if (count == 0 || std::max(maxLocal, localCount) + count > UINT8_MAX + 1)
+    {
+        return false;
+    }
+
+    std::vector<Instruction> hoisted;
+    for (size_t i = 0; i < count; i++)
+    {
+        hoisted.insert(hoisted.end(), instructions.begin() + values[i].start, instructions.begin() + values[i].end + 1);
+        hoisted.push_back(Instruction{.op = Operation::SetLocal, .args = {(uint8_t)(localCount + i)}});
+    }
+    // new variables are placed before all variables declared inside of the loop
+    for (size_t i = header; i <= back; i++)
+    {
+        std::vector<size_t> localArgs = getLocalArguments(instructions[i].op);
+        for (std::vector<size_t>::const_iterator it = localArgs.begin(); it != localArgs.end(); it++)
+        {
+            if (instructions[i].args[*it] >= localCount)
+            {
+                instructions[i].args[*it] += count;
+            }
+        }
+    }
+    for (size_t i = count; i > 0; i--)
+    {
+        StackValue const &value = values[i - 1];
+        m_code.replace(value.start, value.end - value.start + 1, {Instruction{.op = Operation::GetLocal, .args = {(uint8_t)(localCount + i - 1)}}});
+        back -= value.end - value.start;
+    }
+    exit = back + 1;
+
+    // new variables are freed only when leaving the loop, code before the loop can still jump to the original instruction
+    m_code.insert(exit, {Instruction{.op = Operation::ShrinkLocal, .args = {(uint8_t)count}}});
+    for (size_t i = header; i <= back; i++)
+    {
+        if (instructions[i].hasTarget && instructions[i].target == exit + 1)
+        {
+            instructions[i].target = exit;
+        }
+    }
+    // only the code entering the loop has to calculate the values, loop itself keeps jumping to the condition
+    m_code.insert(header, hoisted);
+    size_t newHeader = header + hoisted.size();
+    size_t newBack = back + hoisted.size();
+    for (size_t i = 0; i < instructions.size(); i++)
+    {
+        if ((i < newHeader || i > newBack) && instructions[i].hasTarget && instructions[i].target == newHeader)
+        {
+            instructions[i].target = header;
+        }
+    }
+    for (std::vector<size_t>::iterator it = m_code.getFunctionStarts().begin(); it != m_code.getFunctionStarts().end(); it++)
+    {
+        if (*it == newHeader)
+        {
+            *it = header;
+        }
+    }
+    return true;
+}
+
+std::vector<GobLang::Compiler::LoopInvariantCodeMotion::StackValue> GobLang::Compiler::LoopInvariantCodeMotion::_findInvariantValues(size_t header, size_t back, size_t localCount) const
+{
+    std::vector<Instruction> const &instructions = m_code.getInstructions();
+    LoopEffects effects = _getLoopEffects(header, back);
+    std::vector<bool> isJumpTarget = m_code.getJumpTargets();
+    bool arraysInvariant = !effects.writesArrays && !effects.hasUnknownCalls;
+
+    std::vector<StackValue> stack;
+    std::vector<StackValue> result;
+    // only code of the condition before the first jump is executed every time the loop is reached
+    for (size_t i = header; i <= back && !instructions[i].hasTarget && (i == header || !isJumpTarget[i]); i++)
+    {
+        Instruction const &instr = instructions[i];
+        StackValue value = StackValue{.start = i, .end = i, .isInvariant = true, .isExpensive = false};
+        size_t popCount = 0;
+        bool isSupported = true;
+        switch (instr.op)
+        {
+        case Operation::PushConstInt:
+        case Operation::PushConstUnsignedInt:
+        case Operation::PushConstFloat:
+        case Operation::PushConstChar:
+        case Operation::PushTrue:
+        case Operation::PushFalse:
+        case Operation::PushNull:
+            break;
+        case Operation::GetLocal:
+            value.isInvariant = instr.args[0] < localCount && !effects.writtenLocals[instr.args[0]];
+            break;
+        case Operation::GetGlobal:
+            value.isInvariant = !effects.writtenGlobals[instr.args[0]] && !effects.hasUnknownCalls;
+            break;
+        case Operation::GetArray:
+        case Operation::GetArrayUnchecked:
+            popCount = 2;
+            value.isInvariant = arraysInvariant;
+            value.isExpensive = true;
+            break;
+        case Operation::GetArrayLocal:
+        case Operation::GetArrayLocalUnchecked:
+            popCount = 1;
+            value.isInvariant = arraysInvariant && instr.args[0] < localCount && !effects.writtenLocals[instr.args[0]];
+            value.isExpensive = true;
+            break;
+        case Operation::CallNative:
+            // result of a pure function only changes together with its arguments or sizes of arrays passed to it
+            isSupported = instr.args[0] < m_byteCode.nativeEffects.size() &&
+                          m_byteCode.nativeEffects[instr.args[0]] == NativeFunctionEffect::Pure;
+            popCount = instr.args[1];
+            value.isInvariant = !effects.hasUnknownCalls;
+            value.isExpensive = true;
+            break;
+        default:
+        {
+            Operation generic = getGenericOperation(instr.op);
+            int32_t effect = 0;
+            isSupported = (isArithmeticOperation(generic) || isComparisonOperation(generic) ||
+                           generic == Operation::And || generic == Operation::Or ||
+                           generic == Operation::Not || generic == Operation::Negate || generic == Operation::BitNot) &&
+                          getStackEffect(instr, effect);
+            popCount = 1 - effect;
+        }
+        break;
+        }
+        if (!isSupported || stack.size() < popCount)
+        {
+            break;
+        }
+        std::vector<StackValue> args(stack.end() - popCount, stack.end());
+        stack.erase(stack.end() - popCount, stack.end());
+        for (std::vector<StackValue>::const_iterator it = args.begin(); it != args.end(); it++)
+        {
+            value.start = std::min(value.start, it->start);
+            value.isInvariant &= it->isInvariant;
+            value.isExpensive |= it->isExpensive;
+        }
+        // largest invariant parts of the value are moved instead of the value itself
+        if (!value.isInvariant)
+        {
+            for (std::vector<StackValue>::const_iterator it = args.begin(); it != args.end(); it++)
+            {
+                if (it->isInvariant && it->isExpensive)
+                {
+                    result.push_back(*it);
+                }
+            }
+        }
+        stack.push_back(value);
+    }
+    for (std::vector<StackValue>::const_iterator it = stack.begin(); it != stack.end(); it++)
+    {
+        if (it->isInvariant && it->isExpensive)
+        {
+            result.push_back(*it);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](StackValue const &a, StackValue const &b)
+              { return a.start < b.start; });
+    return result;
+}
+
+GobLang::Compiler::LoopInvariantCodeMotion::LoopEffects GobLang::Compiler::LoopInvariantCodeMotion::_getLoopEffects(size_t header, size_t back) const
+{
+    std::vector<Instruction> const &instructions = m_code.getInstructions();
+    LoopEffects effects;
+    for (size_t i = header; i <= back; i++)
+    {
+        Instruction const &instr = instructions[i];
+        switch (getInstructionEffect(instr, m_byteCode))
+        {
+        case InstructionEffect::WritesLocal:
+            effects.writtenLocals[instr.args[0]] = true;
+            break;
+        case InstructionEffect::WritesGlobal:
+            effects.writtenGlobals[instr.args[0]] = true;
+            break;
+        case InstructionEffect::WritesArrays:
+            effects.writesArrays = true;
+            break;
+        case InstructionEffect::Unknown:
+            effects.hasUnknownCalls = true;
+            break;
+        default:
+            break;
+        }
+    }
+    return effects;
+}
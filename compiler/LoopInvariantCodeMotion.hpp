@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "ByteCode.hpp"
+#include "InstructionList.hpp"
+namespace GobLang::Compiler
+{
+    /**
+     * @brief Pass that moves calculations which produce the same value on every iteration out of the `while` loop conditions.
+     * Values are calculated once before the loop and stored into new local variables which are freed once the loop ends
+     *
+     */
+    class LoopInvariantCodeMotion
+    {
+    public:
+        explicit LoopInvariantCodeMotion(ByteCode const &code) : m_byteCode(code) {}
+
+        /**
+         * @brief Move invariant code out of all loops and write the new code into the byte code
+         *
+         */
+        void optimize();
+
+        ByteCode getByteCode() const { return m_byteCode; }
+
+    private:
+        /**
+         * @brief Value that would be placed on the operation stack while executing the loop condition
+         *
+         */
+        struct StackValue
+        {
+            /**
+             * @brief Index of the first instruction that calculates the value
+             *
+             */
+            size_t start;
+            /**
+             * @brief Index of the last instruction that calculates the value
+             *
+             */
+            size_t end;
+            bool isInvariant;
+            /**
+             * @brief If true calculating the value involves more than just reading variables and constants, so it is worth moving
+             *
+             */
+            bool isExpensive;
+        };
+
+        /**
+         * @brief Operations of the loop that limit which values can be treated as invariant
+         *
+         */
+        struct LoopEffects
+        {
+            std::vector<bool> writtenLocals = std::vector<bool>(UINT8_MAX + 1, false);
+            std::vector<bool> writtenGlobals = std::vector<bool>(UINT8_MAX + 1, false);
+            bool writesArrays = false;
+            /**
+             * @brief Loop calls functions that can change any value
+             *
+             */
+            bool hasUnknownCalls = false;
+        };
+
+        /**
+         * @brief Try moving invariant code out of a single loop
+         *
+         * @param header Index of the first instruction of the loop condition
+         * @param back Index of the jump back to the loop condition
+         * @param localCount Amount of local variables before the loop
+         * @return true Code was changed
+         */
+        bool _optimizeLoop(size_t header, size_t back, size_t localCount);
+
+        /**
+         * @brief Find values calculated at the start of the loop condition that are the same on every iteration
+         *
+         * @param header Index of the first instruction of the loop condition
+         * @param back Index of the jump back to the loop condition
+         * @param localCount Amount of local variables before the loop
+         * @return std::vector<StackValue> Invariant values that are worth moving, ordered by position in the code
+         */
+        std::vector<StackValue> _findInvariantValues(size_t header, size_t back, size_t localCount) const;
+
+        LoopEffects _getLoopEffects(size_t header, size_t back) const;
+
+        ByteCode m_byteCode;
+        InstructionList m_code;
+    };
+}
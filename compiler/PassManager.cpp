@@ -0,0 +1,38 @@
+#include "PassManager.hpp"
+
+bool GobLang::Compiler::PassManager::setPassEnabled(std::string const &name, bool enabled)
+{
+    bool found = false;
+    for (std::vector<Pass>::iterator it = m_passes.begin(); it != m_passes.end(); it++)
+    {
+        if (it->name == name)
+        {
+            it->isEnabled = enabled;
+            found = true;
+        }
+    }
+    return found;
+}
+
+std::vector<std::string> GobLang::Compiler::PassManager::getPassNames() const
+{
+    std::vector<std::string> names;
+    for (std::vector<Pass>::const_iterator it = m_passes.begin(); it != m_passes.end(); it++)
+    {
+        names.push_back(it->name);
+    }
+    return names;
+}
+
+GobLang::Compiler::ByteCode GobLang::Compiler::PassManager::run(ByteCode const &code) const
+{
+    ByteCode result = code;
+    for (std::vector<Pass>::const_iterator it = m_passes.begin(); it != m_passes.end(); it++)
+    {
+        if (it->isEnabled)
+        {
+            result = it->run(result);
+        }
+    }
+    return result;
+}
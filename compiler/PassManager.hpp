@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+#include "ByteCode.hpp"
+namespace GobLang::Compiler
+{
+    /**
+     * @brief Ordered list of optimization passes that are applied to the generated byte code
+     *
+     */
+    class PassManager
+    {
+    public:
+        /**
+         * @brief Add pass to the end of the list. Pass is constructed from the byte code, changes it in `optimize()` and returns the result in `getByteCode()`
+         *
+         * @tparam T Type of the pass
+         * @param name Name used to refer to the pass
+         */
+        template <class T>
+        void addPass(std::string const &name)
+        {
+            m_passes.push_back(Pass{.name = name, .isEnabled = true, .run = [](ByteCode const &code)
+                                    {
+                                        T pass(code);
+                                        pass.optimize();
+                                        return pass.getByteCode(); }});
+        }
+
+        /**
+         * @brief Enable or disable pass with the given name. Disabled passes are skipped when running
+         *
+         * @param name Name of the pass
+         * @param enabled If true pass will be applied
+         * @return true Pass with the given name exists
+         * @return false There is no pass with such name
+         */
+        bool setPassEnabled(std::string const &name, bool enabled);
+
+        /**
+         * @brief Get names of all passes in the order they are applied
+         *
+         */
+        std::vector<std::string> getPassNames() const;
+
+        /**
+         * @brief Apply every enabled pass to the byte code
+         *
+         * @param code Code to optimize
+         * @return ByteCode Optimized code
+         */
+        ByteCode run(ByteCode const &code) const;
+
+    private:
+        struct Pass
+        {
+            std::string name;
+            bool isEnabled;
+            std::function<ByteCode(ByteCode const &)> run;
+        };
+        std::vector<Pass> m_passes;
+    };
+}
@@ -0,0 +1,118 @@
+#include "PeepholeOptimizer.hpp"
+#include <set>
+
+void GobLang::Compiler::PeepholeOptimizer::optimize()
+{
+    if (!m_code.decode(m_byteCode))
+    {
+        return;
+    }
+    while (_runPass())
+    {
+    }
+    m_code.encode(m_byteCode);
+}
+
+bool GobLang::Compiler::PeepholeOptimizer::_runPass()
+{
+    _findJumpTargets();
+    std::vector<Instruction> &instructions = m_code.getInstructions();
+    bool changed = false;
+    for (size_t i = m_code.resolve(0); i < instructions.size(); i = m_code.next(i))
+    {
+        Instruction &instr = instructions[i];
+        if (instr.hasTarget)
+        {
+            // jumping to another jump can be replaced with jumping directly to its destination
+            size_t target = m_code.resolve(instr.target);
+            std::set<size_t> visited = {i};
+            while (target < instructions.size() && instructions[target].op == Operation::Jump && visited.insert(target).second)
+            {
+                target = m_code.resolve(instructions[target].target);
+            }
+            if (target != instr.target)
+            {
+                instr.target = target;
+                changed = true;
+            }
+            // '&&' and '||' chains jump to operations that check the same value again
+            if (target < instructions.size() && (instr.op == Operation::JumpIfNotOrPop || instr.op == Operation::JumpIfOrPop))
+            {
+                Instruction const &targetInstr = instructions[target];
+                if (targetInstr.op == instr.op)
+                {
+                    instr.target = targetInstr.target;
+                    changed = true;
+                }
+                else if (targetInstr.op == Operation::JumpIfNot)
+                {
+                    // value is removed by the conditional jump either way, so it can be removed right away
+                    instr.relative = false;
+                    if (instr.op == Operation::JumpIfNotOrPop)
+                    {
+                        instr.op = Operation::JumpIfNot;
+                        instr.target = targetInstr.target;
+                    }
+                    else
+                    {
+                        instr.op = Operation::JumpIf;
+                        instr.target = m_code.next(target);
+                    }
+                    changed = true;
+                }
+            }
+        }
+        if ((instr.op == Operation::Jump && instr.target == m_code.next(i)) ||
+            (instr.op == Operation::ShrinkLocal && instr.args[0] == 0))
+        {
+            instr.removed = true;
+            changed = true;
+            continue;
+        }
+        size_t nextId = m_code.next(i);
+        // operations that can be reached from somewhere else can't be merged with the previous one
+        if (nextId >= instructions.size() || m_isJumpTarget[nextId])
+        {
+            continue;
+        }
+        Instruction &next = instructions[nextId];
+        if (instr.op == Operation::SetLocal && next.op == Operation::GetLocal && instr.args == next.args)
+        {
+            instr.op = Operation::SetLocalKeep;
+            next.removed = true;
+            changed = true;
+        }
+        else if (instr.op == Operation::PushTrue && next.op == Operation::JumpIfNot)
+        {
+            instr.removed = true;
+            next.removed = true;
+            changed = true;
+        }
+        else if (instr.op == Operation::PushFalse && next.op == Operation::JumpIfNot)
+        {
+            instr.op = Operation::Jump;
+            instr.hasTarget = true;
+            instr.target = next.target;
+            next.removed = true;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void GobLang::Compiler::PeepholeOptimizer::_findJumpTargets()
+{
+    std::vector<Instruction> const &instructions = m_code.getInstructions();
+    m_isJumpTarget.assign(instructions.size() + 1, false);
+    for (std::vector<Instruction>::const_iterator it = instructions.begin(); it != instructions.end(); it++)
+    {
+        if (!it->removed && it->hasTarget)
+        {
+            m_isJumpTarget[m_code.resolve(it->target)] = true;
+        }
+    }
+    for (std::vector<size_t>::const_iterator it = m_code.getFunctionStarts().begin(); it != m_code.getFunctionStarts().end(); it++)
+    {
+        m_isJumpTarget[m_code.resolve(*it)] = true;
+    }
+}
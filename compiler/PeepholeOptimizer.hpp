@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "ByteCode.hpp"
+#include "InstructionList.hpp"
+namespace GobLang::Compiler
+{
+    /**
+     * @brief Optimizer that replaces short sequences of operations in already generated byte code with cheaper ones
+     *
+     */
+    class PeepholeOptimizer
+    {
+    public:
+        explicit PeepholeOptimizer(ByteCode const &code) : m_byteCode(code) {}
+
+        /**
+         * @brief Apply all optimizations until no more changes can be made and write the new code into the byte code
+         *
+         */
+        void optimize();
+
+        ByteCode getByteCode() const { return m_byteCode; }
+
+    private:
+        /**
+         * @brief Perform one pass over the instructions
+         *
+         * @return true Code was changed
+         */
+        bool _runPass();
+
+        /**
+         * @brief Find which instructions can be reached by jumps or function calls.
+         * Such instructions can't be merged with operations before them
+         *
+         */
+        void _findJumpTargets();
+
+        ByteCode m_byteCode;
+        InstructionList m_code;
+        std::vector<bool> m_isJumpTarget;
+    };
+}
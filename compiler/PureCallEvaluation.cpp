@@ -0,0 +1,221 @@
+#include "PureCallEvaluation.hpp"
+#include "Compiler.hpp"
+#include "../execution/Machine.hpp"
+#include <map>
+#include <algorithm>
+
+/**
+ * @brief Check if the operation pushes a constant that can be used as an argument
+ *
+ */
+static bool isConstantPush(GobLang::Operation op)
+{
+    switch (op)
+    {
+    case GobLang::Operation::PushConstInt:
+    case GobLang::Operation::PushConstUnsignedInt:
+    case GobLang::Operation::PushConstFloat:
+    case GobLang::Operation::PushConstChar:
+    case GobLang::Operation::PushTrue:
+    case GobLang::Operation::PushFalse:
+    case GobLang::Operation::PushNull:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void GobLang::Compiler::PureCallEvaluation::optimize()
+{
+    if (!m_code.decode(m_byteCode))
+    {
+        return;
+    }
+    std::vector<bool> isPure = _findPureFunctions();
+    if (std::find(isPure.begin(), isPure.end(), true) == isPure.end())
+    {
+        return;
+    }
+    // evaluated code must not see changes made by replacing calls
+    InstructionList original = m_code;
+    std::vector<Instruction> &instructions = m_code.getInstructions();
+    std::vector<size_t> const &starts = m_code.getFunctionStarts();
+    std::vector<bool> isJumpTarget = m_code.getJumpTargets();
+    // results of calls with the same arguments are only calculated once, with failed calls stored as removed instructions
+    std::map<std::pair<size_t, std::vector<uint8_t>>, Instruction> results;
+    bool changed = false;
+    // calls are processed from the end, so replacing them doesn't move calls that weren't processed yet
+    for (size_t i = instructions.size(); i > 0; i--)
+    {
+        Instruction const &call = instructions[i - 1];
+        if ((call.op != Operation::CallLocal && call.op != Operation::TailCallLocal) ||
+            call.args[0] >= isPure.size() || !isPure[call.args[0]])
+        {
+            continue;
+        }
+        size_t funcId = call.args[0];
+        size_t argCount = m_byteCode.functions[funcId].arguments.size();
+        if (argCount > i - 1)
+        {
+            continue;
+        }
+        size_t first = i - 1 - argCount;
+        bool isConstant = true;
+        std::vector<uint8_t> key;
+        for (size_t j = first; j < i - 1 && isConstant; j++)
+        {
+            // argument values could come from other paths if code jumps between them
+            isConstant = isConstantPush(instructions[j].op) && (j == first || !isJumpTarget[j]) &&
+                         std::find(starts.begin(), starts.end(), j + 1) == starts.end();
+            key.push_back((uint8_t)instructions[j].op);
+            key.insert(key.end(), instructions[j].args.begin(), instructions[j].args.end());
+        }
+        if (!isConstant || (argCount > 0 && isJumpTarget[i - 1]))
+        {
+            continue;
+        }
+        std::pair<size_t, std::vector<uint8_t>> resultKey = {funcId, key};
+        if (results.count(resultKey) == 0)
+        {
+            Instruction result = Instruction{.op = Operation::PushNull, .args = {}, .removed = true};
+            std::vector<Instruction> args(instructions.begin() + first, instructions.begin() + (i - 1));
+            if (m_remainingSteps > 0 && _evaluate(original, funcId, args, result))
+            {
+                result.removed = false;
+            }
+            results[resultKey] = result;
+        }
+        Instruction const &result = results[resultKey];
+        if (result.removed)
+        {
+            continue;
+        }
+        std::vector<Instruction> replacement = {result};
+        if (call.op == Operation::TailCallLocal)
+        {
+            replacement.push_back(Instruction{.op = Operation::ReturnValue, .args = {}});
+        }
+        m_code.replace(first, argCount + 1, replacement);
+        changed = true;
+    }
+    if (changed)
+    {
+        m_code.encode(m_byteCode);
+    }
+}
+
+std::vector<bool> GobLang::Compiler::PureCallEvaluation::_findPureFunctions() const
+{
+    std::vector<Instruction> const &instructions = m_code.getInstructions();
+    std::vector<size_t> const &starts = m_code.getFunctionStarts();
+    std::vector<bool> isPure(starts.size(), true);
+    // functions are pure until they are proven to call impure functions, which is repeated until nothing changes
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t i = 0; i < starts.size(); i++)
+        {
+            if (!isPure[i])
+            {
+                continue;
+            }
+            bool pure = true;
+            size_t end = m_code.getCodeEnd(starts[i]);
+            for (size_t j = starts[i]; j < end && pure; j++)
+            {
+                Instruction const &instr = instructions[j];
+                switch (instr.op)
+                {
+                case Operation::GetGlobal:
+                case Operation::SetGlobal:
+                case Operation::OperateGlobal:
+                case Operation::Get:
+                case Operation::Set:
+                case Operation::Call:
+                case Operation::CallNative:
+                    pure = false;
+                    break;
+                case Operation::CallLocal:
+                case Operation::TailCallLocal:
+                    pure = instr.args[0] < isPure.size() && isPure[instr.args[0]];
+                    break;
+                default:
+                    break;
+                }
+            }
+            if (!pure)
+            {
+                isPure[i] = false;
+                changed = true;
+            }
+        }
+    }
+    return isPure;
+}
+
+bool GobLang::Compiler::PureCallEvaluation::_evaluate(InstructionList const &code, size_t funcId, std::vector<Instruction> const &args, Instruction &result)
+{
+    // code starts by calling the function and stopping, the rest of the main code is never reached
+    InstructionList callCode = code;
+    std::vector<Instruction> entry = args;
+    entry.push_back(Instruction{.op = Operation::CallLocal, .args = {(uint8_t)funcId}});
+    entry.push_back(Instruction{.op = Operation::End, .args = {}});
+    callCode.insert(0, entry);
+    ByteCode byteCode = m_byteCode;
+    callCode.encode(byteCode);
+
+    Machine machine(byteCode);
+    MemoryValue value;
+    try
+    {
+        size_t steps = 0;
+        while (!machine.isAtTheEnd())
+        {
+            // every call has its own limit, but all calls also share the limit of the whole compilation
+            if (steps >= MaxEvaluationSteps || m_remainingSteps == 0)
+            {
+                return false;
+            }
+            steps++;
+            m_remainingSteps--;
+            machine.step();
+        }
+        // functions that return without a value leave nothing on the stack
+        MemoryValue *top = machine.getStackTopAndPop();
+        if (top == nullptr)
+        {
+            return false;
+        }
+        value = *top;
+        delete top;
+    }
+    // any error is left to happen at runtime, where it can be reported in the right place
+    catch (std::exception const &e)
+    {
+        return false;
+    }
+    switch (value.type)
+    {
+    case Type::Int:
+        result = Instruction{.op = Operation::PushConstInt, .args = parseToBytes(value.value.integer)};
+        return true;
+    case Type::UnsignedInt:
+        result = Instruction{.op = Operation::PushConstUnsignedInt, .args = parseToBytes(value.value.unsignedInteger)};
+        return true;
+    case Type::Float:
+        result = Instruction{.op = Operation::PushConstFloat, .args = parseToBytes(value.value.floating)};
+        return true;
+    case Type::Char:
+        result = Instruction{.op = Operation::PushConstChar, .args = {(uint8_t)value.value.character}};
+        return true;
+    case Type::Bool:
+        result = Instruction{.op = value.value.boolean ? Operation::PushTrue : Operation::PushFalse, .args = {}};
+        return true;
+    case Type::Null:
+        result = Instruction{.op = Operation::PushNull, .args = {}};
+        return true;
+    default:
+        return false;
+    }
+}
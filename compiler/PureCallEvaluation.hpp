@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "ByteCode.hpp"
+#include "InstructionList.hpp"
+namespace GobLang::Compiler
+{
+    /**
+     * @brief Pass that calculates calls to pure functions with constant arguments during compilation.
+     * Call is executed on a separate machine and replaced by the value it returned, if it finished without errors in a limited amount of steps
+     *
+     */
+    class PureCallEvaluation
+    {
+    public:
+        /**
+         * @brief Max amount of operations a single call can execute before it is left for the runtime
+         *
+         */
+        static constexpr size_t MaxEvaluationSteps = 1000000;
+
+        /**
+         * @brief Max amount of operations all calls evaluated during a single compilation can execute together
+         *
+         */
+        static constexpr size_t MaxTotalEvaluationSteps = 4000000;
+
+        explicit PureCallEvaluation(ByteCode const &code) : m_byteCode(code) {}
+
+        /**
+         * @brief Replace calls with their results and write the new code into the byte code
+         *
+         */
+        void optimize();
+
+        ByteCode getByteCode() const { return m_byteCode; }
+
+    private:
+        /**
+         * @brief Find functions that only use their arguments, local variables and other pure functions.
+         * Native functions are not bound during compilation, so functions that call them are not pure
+         *
+         */
+        std::vector<bool> _findPureFunctions() const;
+
+        /**
+         * @brief Execute the function with the given arguments
+         *
+         * @param code Decoded original code
+         * @param funcId Id of the function to call
+         * @param args Instructions that push arguments of the call
+         * @param result Where to write the instruction that pushes the returned value
+         * @return true Function returned a value that can be written as a constant
+         * @return false Function failed, didn't finish in time or returned an object
+         */
+        bool _evaluate(InstructionList const &code, size_t funcId, std::vector<Instruction> const &args, Instruction &result);
+
+        ByteCode m_byteCode;
+        InstructionList m_code;
+        /**
+         * @brief Amount of operations that evaluated calls can still execute
+         *
+         */
+        size_t m_remainingSteps = MaxTotalEvaluationSteps;
+    };
+}
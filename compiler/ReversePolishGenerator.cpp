@@ -9,7 +9,7 @@ void GobLang::Compiler::ReversePolishGenerator::compile()
             if (m_isVariableDeclaration)
             {
                 _appendVariable(id->getId());
-                LocalVarToken *local = new LocalVarToken(id->getRow(), id->getColumn(), _getLocalVariableAccessId(id->getId()));
+                LocalVarToken *local = new LocalVarToken(id->getRow(), id->getColumn(), _getLocalVariableAccessId(id->getId()), true, _isAssignmentDestination(m_it));
                 addToken(local);
                 m_compilerTokens.push_back(local);
                 m_isVariableDeclaration = false;
@@ -25,7 +25,7 @@ void GobLang::Compiler::ReversePolishGenerator::compile()
             }
             else if (int32_t varId = _getLocalVariableAccessId(id->getId()); varId != -1)
             {
-                LocalVarToken *local = new LocalVarToken(id->getRow(), id->getColumn(), varId);
+                LocalVarToken *local = new LocalVarToken(id->getRow(), id->getColumn(), varId, false, _isAssignmentDestination(m_it));
                 addToken(local);
                 m_compilerTokens.push_back(local);
             }
@@ -196,6 +196,16 @@ int32_t GobLang::Compiler::ReversePolishGenerator::_getLocalVariableAccessId(siz
     return found ? (int32_t)curr : -1;
 }
 
+bool GobLang::Compiler::ReversePolishGenerator::_isAssignmentDestination(std::vector<Token *>::const_iterator const &it)
+{
+    if (it + 1 == m_parser.getTokens().end())
+    {
+        return false;
+    }
+    OperatorToken *opToken = dynamic_cast<OperatorToken *>(*(it + 1));
+    return opToken != nullptr && opToken->isAssignment();
+}
+
 void GobLang::Compiler::ReversePolishGenerator::_appendVariableBlock()
 {
     m_blockVariables.push_back({});
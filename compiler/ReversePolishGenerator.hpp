@@ -76,6 +76,13 @@ namespace GobLang::Compiler
         void _appendVariableBlock();
         void _popVariableBlock();
         void _appendVariable(size_t stringId);
+
+        /**
+         * @brief Check if variable at the given position is followed by an assignment operator and will have its value changed
+         *
+         * @param it Iterator pointing to the variable token
+         */
+        bool _isAssignmentDestination(std::vector<Token *>::const_iterator const &it);
         void _compileSeparators(SeparatorToken *sepToken, std::vector<Token *>::const_iterator const &it);
         
         /**
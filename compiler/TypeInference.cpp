@@ -0,0 +1,251 @@
+#include "TypeInference.hpp"
+
+bool GobLang::Compiler::getBinaryOperationType(Operation op, Type a, Type b, Type &result)
+{
+    // machine fails on every operation with operands of different types, so result only matters when they match
+    if (a != b)
+    {
+        return false;
+    }
+    switch (op)
+    {
+    case Operation::Add:
+    case Operation::Sub:
+    case Operation::Mul:
+    case Operation::Div:
+        if (a != Type::Int && a != Type::UnsignedInt && a != Type::Float)
+        {
+            return false;
+        }
+        result = a;
+        return true;
+    case Operation::Modulo:
+    case Operation::BitAnd:
+    case Operation::BitOr:
+    case Operation::BitXor:
+    case Operation::ShiftLeft:
+    case Operation::ShiftRight:
+        if (a != Type::Int && a != Type::UnsignedInt)
+        {
+            return false;
+        }
+        result = a;
+        return true;
+    case Operation::Equals:
+    case Operation::NotEq:
+    case Operation::Less:
+    case Operation::More:
+    case Operation::LessOrEq:
+    case Operation::MoreOrEq:
+        result = Type::Bool;
+        return true;
+    case Operation::And:
+    case Operation::Or:
+        // right side is used as the result without checking its type
+        if (a != Type::Bool)
+        {
+            return false;
+        }
+        result = Type::Bool;
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool GobLang::Compiler::getUnaryOperationType(Operation op, Type a, Type &result)
+{
+    switch (op)
+    {
+    case Operation::Not:
+        result = Type::Bool;
+        return true;
+    case Operation::Negate:
+        if (a != Type::Int && a != Type::Float)
+        {
+            return false;
+        }
+        result = a;
+        return true;
+    case Operation::BitNot:
+        if (a != Type::Int && a != Type::UnsignedInt)
+        {
+            return false;
+        }
+        result = a;
+        return true;
+    default:
+        return false;
+    }
+}
+
+void GobLang::Compiler::TypeInference::run()
+{
+    // variables can only go from having no type, to having a single type, to being untyped, so this always ends
+    while (_runPass())
+    {
+    }
+}
+
+bool GobLang::Compiler::TypeInference::_runPass()
+{
+    bool changed = false;
+    std::vector<StackValue> stack;
+    for (std::vector<Token *>::const_iterator it = m_tokens.begin(); it != m_tokens.end(); it++)
+    {
+        if (SeparatorToken *sepTok = dynamic_cast<SeparatorToken *>(*it); sepTok != nullptr && sepTok->getSeparator() == Separator::End)
+        {
+            if (!stack.empty())
+            {
+                stack.pop_back();
+            }
+        }
+        else if (dynamic_cast<BoolConstToken *>(*it) != nullptr)
+        {
+            stack.push_back(StackValue{.isKnown = true, .type = Type::Bool});
+        }
+        else if (dynamic_cast<IntToken *>(*it) != nullptr)
+        {
+            stack.push_back(StackValue{.isKnown = true, .type = Type::Int});
+        }
+        else if (dynamic_cast<UnsignedIntToken *>(*it) != nullptr)
+        {
+            stack.push_back(StackValue{.isKnown = true, .type = Type::UnsignedInt});
+        }
+        else if (dynamic_cast<FloatToken *>(*it) != nullptr)
+        {
+            stack.push_back(StackValue{.isKnown = true, .type = Type::Float});
+        }
+        else if (dynamic_cast<CharToken *>(*it) != nullptr)
+        {
+            stack.push_back(StackValue{.isKnown = true, .type = Type::Char});
+        }
+        else if (dynamic_cast<StringToken *>(*it) != nullptr ||
+                 dynamic_cast<NullConstToken *>(*it) != nullptr ||
+                 dynamic_cast<IdToken *>(*it) != nullptr)
+        {
+            stack.push_back(StackValue{});
+        }
+        else if (LocalVarToken const *localToken = dynamic_cast<LocalVarToken const *>(*it); localToken != nullptr)
+        {
+            StackValue value;
+            if (localToken->isDeclaration())
+            {
+                value.variable = localToken;
+                // declaration without a value leaves the variable without a type
+                if (!localToken->isAssigned() && m_untypedLocals.insert(localToken).second)
+                {
+                    changed = true;
+                }
+            }
+            else if (std::map<LocalVarToken const *, LocalVarToken const *>::const_iterator declIt = m_declarations.find(localToken);
+                     declIt != m_declarations.end())
+            {
+                value.variable = declIt->second;
+            }
+            if (value.variable != nullptr && m_untypedLocals.count(value.variable) == 0)
+            {
+                if (std::map<LocalVarToken const *, Type>::const_iterator typeIt = m_localTypes.find(value.variable);
+                    typeIt != m_localTypes.end())
+                {
+                    value.isKnown = true;
+                    value.type = typeIt->second;
+                }
+            }
+            stack.push_back(value);
+        }
+        else if (GotoToken *jmpToken = dynamic_cast<GotoToken *>(*it); jmpToken != nullptr)
+        {
+            if (dynamic_cast<IfToken *>(jmpToken) != nullptr || dynamic_cast<WhileToken *>(jmpToken) != nullptr)
+            {
+                _pop(stack);
+            }
+        }
+        else if (MultiArgToken *multiTok = dynamic_cast<MultiArgToken *>(*it); multiTok != nullptr)
+        {
+            for (int32_t i = 0; i < multiTok->getArgCount(); i++)
+            {
+                _pop(stack);
+            }
+            if (FunctionCallToken *func = dynamic_cast<FunctionCallToken *>(*it); func != nullptr && !func->usesLocalFunction())
+            {
+                _pop(stack);
+            }
+            stack.push_back(StackValue{});
+        }
+        else if (ReturnToken *ret = dynamic_cast<ReturnToken *>(*it); ret != nullptr)
+        {
+            if (ret->hasValue())
+            {
+                _pop(stack);
+            }
+        }
+        else if (OperatorToken *opToken = dynamic_cast<OperatorToken *>(*it); opToken != nullptr)
+        {
+            if (opToken->isUnary())
+            {
+                StackValue value = _pop(stack);
+                StackValue result;
+                result.isKnown = value.isKnown && getUnaryOperationType(opToken->getOperation(), value.type, result.type);
+                stack.push_back(result);
+                continue;
+            }
+            StackValue right = _pop(stack);
+            StackValue left = _pop(stack);
+            StackValue result;
+            result.isKnown = left.isKnown && right.isKnown &&
+                             getBinaryOperationType(opToken->getOperation(), left.type, right.type, result.type);
+            if (opToken->getOperator() == Operator::Assign)
+            {
+                changed |= _assign(left.variable, right);
+            }
+            else if (opToken->isAssignment())
+            {
+                changed |= _assign(left.variable, result);
+            }
+            else
+            {
+                stack.push_back(result);
+            }
+        }
+        else if (dynamic_cast<ArrayIndexToken *>(*it) != nullptr)
+        {
+            _pop(stack);
+            _pop(stack);
+            stack.push_back(StackValue{});
+        }
+    }
+    return changed;
+}
+
+bool GobLang::Compiler::TypeInference::_assign(LocalVarToken const *variable, StackValue const &value)
+{
+    if (variable == nullptr || m_untypedLocals.count(variable) > 0)
+    {
+        return false;
+    }
+    std::map<LocalVarToken const *, Type>::const_iterator typeIt = m_localTypes.find(variable);
+    if (value.isKnown && typeIt == m_localTypes.end())
+    {
+        m_localTypes[variable] = value.type;
+        return true;
+    }
+    if (!value.isKnown || typeIt->second != value.type)
+    {
+        m_localTypes.erase(variable);
+        m_untypedLocals.insert(variable);
+        return true;
+    }
+    return false;
+}
+
+GobLang::Compiler::TypeInference::StackValue GobLang::Compiler::TypeInference::_pop(std::vector<StackValue> &stack)
+{
+    if (stack.empty())
+    {
+        return StackValue{};
+    }
+    StackValue value = stack.back();
+    stack.pop_back();
+    return value;
+}
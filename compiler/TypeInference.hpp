@@ -0,0 +1,106 @@
+#pragma once
+#include <vector>
+#include <map>
+#include <set>
+#include "Token.hpp"
+#include "CompilerToken.hpp"
+#include "../execution/Type.hpp"
+#include "../execution/Operations.hpp"
+namespace GobLang::Compiler
+{
+    /**
+     * @brief Get type of the result of a binary operation if both operands have known types
+     *
+     * @param op Operation to perform
+     * @param a Type of the left operand
+     * @param b Type of the right operand
+     * @param result Where to write the type of the result
+     * @return true Operation always produces value of this type or fails
+     * @return false Type of the result can't be known during compilation
+     */
+    bool getBinaryOperationType(Operation op, Type a, Type b, Type &result);
+
+    /**
+     * @brief Get type of the result of a unary operation if operand has known type
+     *
+     * @param op Operation to perform
+     * @param a Type of the operand
+     * @param result Where to write the type of the result
+     * @return true Operation always produces value of this type or fails
+     * @return false Type of the result can't be known during compilation
+     */
+    bool getUnaryOperationType(Operation op, Type a, Type &result);
+
+    /**
+     * @brief Pass over the reverse polish notation code of a single function that finds local variables which always store values of the same type
+     *
+     */
+    class TypeInference
+    {
+    public:
+        /**
+         * @param tokens Code of the main program or a single function
+         * @param declarations Declaration of the variable used by each local variable token
+         */
+        explicit TypeInference(std::vector<Token *> const &tokens,
+                               std::map<LocalVarToken const *, LocalVarToken const *> const &declarations)
+            : m_tokens(tokens), m_declarations(declarations) {}
+
+        /**
+         * @brief Process the code until types of all variables are known
+         *
+         */
+        void run();
+
+        /**
+         * @brief Types of local variables that only ever store values of one type. Key is the declaration of the variable
+         *
+         */
+        std::map<LocalVarToken const *, Type> const &getLocalTypes() const { return m_localTypes; }
+
+    private:
+        /**
+         * @brief Value that would be placed on the compiler stack
+         *
+         */
+        struct StackValue
+        {
+            bool isKnown = false;
+            Type type = Type::Null;
+            /**
+             * @brief Declaration of the variable if this value is a local variable
+             *
+             */
+            LocalVarToken const *variable = nullptr;
+        };
+
+        /**
+         * @brief Process the code once using types found so far
+         *
+         * @return true Type of at least one variable has changed
+         */
+        bool _runPass();
+
+        /**
+         * @brief Record that value of the given type is stored in the variable
+         *
+         * @return true Type of the variable has changed
+         */
+        bool _assign(LocalVarToken const *variable, StackValue const &value);
+
+        /**
+         * @brief Remove value from the top of the stack, returning unknown value if stack is empty
+         *
+         */
+        StackValue _pop(std::vector<StackValue> &stack);
+
+        std::vector<Token *> const &m_tokens;
+        std::map<LocalVarToken const *, LocalVarToken const *> const &m_declarations;
+        std::map<LocalVarToken const *, Type> m_localTypes;
+        /**
+         * @brief Variables that store values of different or unknown types
+         *
+         */
+        std::set<LocalVarToken const *> m_untypedLocals;
+    };
+}
@@ -1,7 +1,7 @@
 #include "Array.hpp"
 #include "Value.hpp"
 #include "Exception.hpp"
-GobLang::ArrayNode::ArrayNode(size_t size)
+GobLang::ArrayNode::ArrayNode(size_t size) : MemoryNode(nodeKind())
 {
     m_data = std::vector<MemoryValue>(size);
 }
@@ -15,15 +15,6 @@ void GobLang::ArrayNode::setItem(size_t i, MemoryValue const &item)
             " in array of size " +
             std::to_string(m_data.size()));
     }
-    // check if object that we are setting is itself to avoid creating a ref cycle
-    if (item.type == Type::MemoryObj && std::get<MemoryNode *>(item.value) != this)
-    {
-        std::get<MemoryNode *>(item.value)->increaseRefCount();
-    }
-    if (m_data[i].type == Type::MemoryObj && std::get<MemoryNode *>(m_data[i].value) != this)
-    {
-        std::get<MemoryNode *>(m_data[i].value)->decreaseRefCount();
-    }
     m_data[i] = item;
 }
 
@@ -61,21 +52,13 @@ std::string GobLang::ArrayNode::toString(bool pretty)
 
 void GobLang::ArrayNode::append(MemoryValue const &item)
 {
-    // check if object that we are setting is itself to avoid creating a ref cycle
-    if (item.type == Type::MemoryObj && std::get<MemoryNode *>(item.value) != this)
-    {
-        std::get<MemoryNode *>(item.value)->increaseRefCount();
-    }
     m_data.push_back(item);
 }
 
-GobLang::ArrayNode::~ArrayNode()
+void GobLang::ArrayNode::trace(MemoryTracer &tracer)
 {
     for (std::vector<MemoryValue>::iterator it = m_data.begin(); it != m_data.end(); it++)
     {
-        if (it->type == Type::MemoryObj)
-        {
-            std::get<MemoryNode *>(it->value)->decreaseRefCount();
-        }
+        tracer.mark(*it);
     }
 }
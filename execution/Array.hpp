@@ -9,16 +9,32 @@ namespace GobLang
     public:
         explicit ArrayNode(size_t size);
 
+        static MemoryNodeKind nodeKind() { return MemoryNodeKinds::Array; }
+
         void setItem(size_t i, MemoryValue const &item);
         MemoryValue *getItem(size_t i);
 
+        /**
+         * @brief Set item without checking if index is inside of the array
+         *
+         */
+        void setItemUnchecked(size_t i, MemoryValue const &item) { m_data[i] = item; }
+
+        /**
+         * @brief Get item without checking if index is inside of the array
+         *
+         */
+        MemoryValue *getItemUnchecked(size_t i) { return &m_data[i]; }
+
         std::string toString(bool pretty) override;
 
         size_t getSize() const { return m_data.size(); }
 
         void append(MemoryValue const& item);
 
-        virtual ~ArrayNode();
+        void trace(MemoryTracer &tracer) override;
+
+        virtual ~ArrayNode() = default;
 
     private:
         std::vector<MemoryValue> m_data;
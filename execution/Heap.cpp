@@ -0,0 +1,155 @@
+#include "Heap.hpp"
+
+GobLang::HeapPage::HeapPage(size_t slotSize, size_t slotCount) : slotSize(slotSize),
+                                                                  slotCount(slotCount),
+                                                                  memory(new uint8_t[slotSize * slotCount]),
+                                                                  used(new bool[slotCount]())
+{
+}
+
+void GobLang::Heap::addForeign(MemoryNode *node)
+{
+    if (node == nullptr)
+    {
+        return;
+    }
+    m_foreignRoot.insert(node);
+    m_objectCount++;
+    m_allocationCount++;
+}
+
+void GobLang::Heap::markPinned(MemoryTracer &tracer)
+{
+    for (size_t sizeClass = 0; sizeClass < SizeClassCount; sizeClass++)
+    {
+        for (std::vector<std::unique_ptr<HeapPage>>::iterator pageIt = m_pages[sizeClass].begin(); pageIt != m_pages[sizeClass].end(); pageIt++)
+        {
+            HeapPage *page = pageIt->get();
+            for (size_t i = 0; i < page->slotCount && page->usedCount > 0; i++)
+            {
+                if (page->used[i] && page->getNode(i)->getRefCount() > 0)
+                {
+                    tracer.mark(page->getNode(i));
+                }
+            }
+        }
+    }
+    for (MemoryNode *curr = m_foreignRoot.getNext(); curr != nullptr; curr = curr->getNext())
+    {
+        if (curr->getRefCount() > 0)
+        {
+            tracer.mark(curr);
+        }
+    }
+}
+
+void GobLang::Heap::sweep(std::function<void(MemoryNode *)> const &beforeDelete)
+{
+    for (size_t sizeClass = 0; sizeClass < SizeClassCount; sizeClass++)
+    {
+        for (std::vector<std::unique_ptr<HeapPage>>::iterator pageIt = m_pages[sizeClass].begin(); pageIt != m_pages[sizeClass].end(); pageIt++)
+        {
+            HeapPage *page = pageIt->get();
+            if (page->usedCount == 0)
+            {
+                continue;
+            }
+            // raw pointers are used since this loop touches every object in the heap
+            bool *used = page->used.get();
+            uint8_t *memory = page->memory.get();
+            for (size_t i = 0; i < page->slotCount; i++)
+            {
+                if (!used[i])
+                {
+                    continue;
+                }
+                MemoryNode *node = reinterpret_cast<MemoryNode *>(memory + i * page->slotSize);
+                if (!node->isDead())
+                {
+                    node->setMarked(false);
+                    continue;
+                }
+                beforeDelete(node);
+                node->~MemoryNode();
+                _release(sizeClass, page, i);
+                m_objectCount--;
+            }
+        }
+    }
+
+    MemoryNode *prev = &m_foreignRoot;
+    MemoryNode *curr = m_foreignRoot.getNext();
+    while (curr != nullptr)
+    {
+        if (!curr->isDead())
+        {
+            curr->setMarked(false);
+            prev = curr;
+            curr = curr->getNext();
+            continue;
+        }
+        // if we are deleting then prev should stay the same while
+        // curr gets deleted
+        MemoryNode *del = curr;
+        prev->eraseNext();
+        curr = prev->getNext();
+        beforeDelete(del);
+        delete del;
+        m_objectCount--;
+    }
+}
+
+GobLang::Heap::~Heap()
+{
+    // page memory stays allocated until all page objects are destroyed, so nodes can still safely touch each other in destructors
+    for (size_t sizeClass = 0; sizeClass < SizeClassCount; sizeClass++)
+    {
+        for (std::vector<std::unique_ptr<HeapPage>>::iterator pageIt = m_pages[sizeClass].begin(); pageIt != m_pages[sizeClass].end(); pageIt++)
+        {
+            HeapPage *page = pageIt->get();
+            for (size_t i = 0; i < page->slotCount; i++)
+            {
+                if (page->used[i])
+                {
+                    page->getNode(i)->~MemoryNode();
+                    page->used[i] = false;
+                }
+            }
+        }
+    }
+    MemoryNode *curr = m_foreignRoot.getNext();
+    while (curr != nullptr)
+    {
+        MemoryNode *del = curr;
+        curr = curr->getNext();
+        delete del;
+    }
+}
+
+std::pair<GobLang::HeapPage *, size_t> GobLang::Heap::_allocate(size_t sizeClass)
+{
+    std::vector<std::pair<HeapPage *, size_t>> &freeSlots = m_freeSlots[sizeClass];
+    if (freeSlots.empty())
+    {
+        size_t slotSize = SizeClasses[sizeClass];
+        m_pages[sizeClass].push_back(std::make_unique<HeapPage>(slotSize, PageSize / slotSize));
+        HeapPage *page = m_pages[sizeClass].back().get();
+        // push in reverse so that slots are handed out in address order
+        for (size_t i = page->slotCount; i > 0; i--)
+        {
+            freeSlots.push_back({page, i - 1});
+        }
+    }
+    std::pair<HeapPage *, size_t> slot = freeSlots.back();
+    freeSlots.pop_back();
+    slot.first->used[slot.second] = true;
+    slot.first->usedCount++;
+    return slot;
+}
+
+void GobLang::Heap::_release(size_t sizeClass, HeapPage *page, size_t index)
+{
+    page->used[index] = false;
+    page->usedCount--;
+    m_freeSlots[sizeClass].push_back({page, index});
+}
\ No newline at end of file
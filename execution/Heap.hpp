@@ -0,0 +1,175 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include "Memory.hpp"
+
+namespace GobLang
+{
+    /**
+     * @brief Block of memory split into equally sized slots each of which can store a single memory node
+     *
+     */
+    struct HeapPage
+    {
+        explicit HeapPage(size_t slotSize, size_t slotCount);
+
+        void *getSlot(size_t index) { return memory.get() + index * slotSize; }
+
+        MemoryNode *getNode(size_t index) { return reinterpret_cast<MemoryNode *>(getSlot(index)); }
+
+        size_t slotSize;
+        size_t slotCount;
+        size_t usedCount = 0;
+        std::unique_ptr<uint8_t[]> memory;
+        /**
+         * @brief Which slots currently store a constructed node
+         *
+         */
+        std::unique_ptr<bool[]> used;
+    };
+
+    /**
+     * @brief Storage for all memory nodes owned by the machine.
+     *
+     * Nodes created via `create` are placed into pages of the smallest size class that fits them,
+     * freed slots are reused through per class free lists so allocation never has to search for space.
+     * Nodes that were allocated elsewhere(such as custom types from native extensions) are kept in a linked list and deleted normally
+     */
+    class Heap
+    {
+    public:
+        /**
+         * @brief Slot sizes used by the heap. Objects larger than the last class are allocated using regular `new`
+         *
+         */
+        static constexpr size_t SizeClasses[] = {32, 64, 96, 128, 192, 256};
+        static constexpr size_t SizeClassCount = sizeof(SizeClasses) / sizeof(SizeClasses[0]);
+        /**
+         * @brief Size in bytes of memory allocated for a single page
+         *
+         */
+        static constexpr size_t PageSize = 4096;
+
+        explicit Heap() = default;
+
+        Heap(Heap const &) = delete;
+
+        Heap &operator=(Heap const &) = delete;
+
+        /**
+         * @brief Create a new memory node inside of the heap
+         *
+         * @tparam T Type of the node
+         * @param args Arguments passed to the constructor of the node
+         * @return T* Pointer to created node
+         */
+        template <typename T, typename... Args>
+        T *create(Args &&...args)
+        {
+            static_assert(std::is_base_of_v<MemoryNode, T>, "Only memory nodes can be stored in the heap");
+            constexpr size_t sizeClass = getSizeClass(sizeof(T));
+            if constexpr (sizeClass >= SizeClassCount || alignof(T) > alignof(std::max_align_t))
+            {
+                T *node = new T(std::forward<Args>(args)...);
+                addForeign(node);
+                return node;
+            }
+            else
+            {
+                std::pair<HeapPage *, size_t> slot = _allocate(sizeClass);
+                try
+                {
+                    T *node = new (slot.first->getSlot(slot.second)) T(std::forward<Args>(args)...);
+                    m_objectCount++;
+                    m_allocationCount++;
+                    return node;
+                }
+                catch (...)
+                {
+                    _release(sizeClass, slot.first, slot.second);
+                    throw;
+                }
+            }
+        }
+
+        /**
+         * @brief Take ownership of a node that was allocated using `new`. Node will be deleted once it is dead and heap is swept
+         *
+         * @param node Node to add
+         */
+        void addForeign(MemoryNode *node);
+
+        /**
+         * @brief Mark all nodes that were pinned by native code
+         *
+         * @param tracer Tracer used for the current collection
+         */
+        void markPinned(MemoryTracer &tracer);
+
+        /**
+         * @brief Delete all nodes that were not marked and reset marks of all surviving nodes
+         *
+         * @param beforeDelete Function called for each dead node right before it is deleted
+         */
+        void sweep(std::function<void(MemoryNode *)> const &beforeDelete);
+
+        /**
+         * @brief Amount of nodes currently stored in the heap
+         *
+         * @return size_t
+         */
+        size_t getObjectCount() const { return m_objectCount; }
+
+        /**
+         * @brief Total amount of nodes that were ever added to the heap
+         *
+         * @return size_t
+         */
+        size_t getAllocationCount() const { return m_allocationCount; }
+
+        /**
+         * @brief Get index of the smallest size class that can fit object of given size
+         *
+         * @param size Size of the object in bytes
+         * @return size_t Index of the class or `SizeClassCount` if object is too large
+         */
+        static constexpr size_t getSizeClass(size_t size)
+        {
+            for (size_t i = 0; i < SizeClassCount; i++)
+            {
+                if (size <= SizeClasses[i])
+                {
+                    return i;
+                }
+            }
+            return SizeClassCount;
+        }
+
+        ~Heap();
+
+    private:
+        std::pair<HeapPage *, size_t> _allocate(size_t sizeClass);
+
+        void _release(size_t sizeClass, HeapPage *page, size_t index);
+
+        std::vector<std::unique_ptr<HeapPage>> m_pages[SizeClassCount];
+        /**
+         * @brief Free slots of every size class as pairs of page and index of the slot in that page
+         *
+         */
+        std::vector<std::pair<HeapPage *, size_t>> m_freeSlots[SizeClassCount];
+        /**
+         * @brief Root of the list of nodes that are not stored in pages. Root itself is never used as an object
+         *
+         */
+        MemoryNode m_foreignRoot;
+        size_t m_objectCount = 0;
+        size_t m_allocationCount = 0;
+    };
+}
\ No newline at end of file
@@ -1,16 +1,32 @@
 #include "Machine.hpp"
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <iterator>
 GobLang::Machine::Machine(Compiler::ByteCode const &code)
 {
     m_constStrings = code.ids;
     m_operations = code.operations;
     m_functions = code.functions;
+    // slots are created in the same order as compiler assigned them so that operands can be used as is
+    for (std::vector<std::string>::const_iterator it = code.globals.begin(); it != code.globals.end(); it++)
+    {
+        _getGlobalSlot(*it);
+    }
+    // native functions are bound later, but ids have to match the ones used by the code
+    for (std::vector<std::string>::const_iterator it = code.natives.begin(); it != code.natives.end(); it++)
+    {
+        _getNativeFunctionId(*it);
+    }
 }
 void GobLang::Machine::addFunction(FunctionValue const &func, std::string const &name)
 
 {
-    m_globals[name] = MemoryValue{.type = Type::NativeFunction, .value = func};
+    size_t id = _getNativeFunctionId(name);
+    m_nativeFunctions[id] = func;
+    MemoryValue funcVal{.type = Type::NativeFunction, .value = Value()};
+    funcVal.value.nativeFunction = (uint32_t)id;
+    _setGlobalValue(_getGlobalSlot(name), funcVal);
 }
 void GobLang::Machine::step()
 {
@@ -21,15 +37,19 @@ void GobLang::Machine::step()
     switch ((Operation)m_operations[m_programCounter])
     {
     case Operation::Add:
+        _quicken(Operation::AddInt, Operation::AddFloat);
         _add();
         break;
     case Operation::Sub:
+        _quicken(Operation::SubInt, Operation::SubFloat);
         _sub();
         break;
     case Operation::Mul:
+        _quicken(Operation::MulInt, Operation::MulFloat);
         _mul();
         break;
     case Operation::Div:
+        _quicken(Operation::DivInt, Operation::DivFloat);
         _div();
         break;
     case Operation::Modulo:
@@ -41,13 +61,27 @@ void GobLang::Machine::step()
     case Operation::CallLocal:
         _callLocal();
         break;
+    case Operation::TailCallLocal:
+        _tailCallLocal();
+        _collectGarbageIfNeeded();
+        return;
+    case Operation::CallNative:
+        _callNative();
+        break;
     case Operation::Set:
         _set();
-        collectGarbage();
+        _collectGarbageIfNeeded();
         break;
     case Operation::Get:
         _get();
         break;
+    case Operation::SetGlobal:
+        _setGlobal();
+        _collectGarbageIfNeeded();
+        break;
+    case Operation::GetGlobal:
+        _getGlobal();
+        break;
     case Operation::GetLocal:
         _getLocal();
         break;
@@ -71,7 +105,7 @@ void GobLang::Machine::step()
         break;
     case Operation::SetLocal:
         _setLocal();
-        collectGarbage();
+        _collectGarbageIfNeeded();
         break;
     case Operation::PushConstInt:
         _pushConstInt();
@@ -93,14 +127,24 @@ void GobLang::Machine::step()
         break;
     case Operation::SetArray:
         _setArray();
-        collectGarbage();
+        _collectGarbageIfNeeded();
         break;
     case Operation::Jump:
         _jump();
+        _collectGarbageIfNeeded();
         return; // this uses return because we want to avoid advancing the counter after jup
     case Operation::JumpIfNot:
         _jumpIf();
         return;
+    case Operation::JumpIf:
+        _jumpIfTrue();
+        return;
+    case Operation::JumpIfNotOrPop:
+        _jumpIfOrPop(false);
+        return;
+    case Operation::JumpIfOrPop:
+        _jumpIfOrPop(true);
+        return;
     case Operation::PushTrue:
         pushToStack(MemoryValue{.type = Type::Bool, .value = true});
         break;
@@ -117,9 +161,11 @@ void GobLang::Machine::step()
         _neq();
         break;
     case Operation::Less:
+        _quicken(Operation::LessInt, Operation::LessFloat);
         _less();
         break;
     case Operation::More:
+        _quicken(Operation::MoreInt, Operation::MoreFloat);
         _more();
         break;
     case Operation::Not:
@@ -132,9 +178,11 @@ void GobLang::Machine::step()
         _or();
         break;
     case Operation::LessOrEq:
+        _quicken(Operation::LessOrEqInt, Operation::LessOrEqFloat);
         _lessOrEq();
         break;
     case Operation::MoreOrEq:
+        _quicken(Operation::MoreOrEqInt, Operation::MoreOrEqFloat);
         _moreOrEq();
         break;
     case Operation::Negate:
@@ -142,11 +190,11 @@ void GobLang::Machine::step()
         break;
     case Operation::ShrinkLocal:
         _shrink();
-        collectGarbage();
+        _collectGarbageIfNeeded();
         break;
     case Operation::Return:
         _return();
-        collectGarbage();
+        _collectGarbageIfNeeded();
         break;
     case Operation::ReturnValue:
         _returnWithValue();
@@ -154,6 +202,96 @@ void GobLang::Machine::step()
     case Operation::CreateArray:
         _createArray();
         break;
+    case Operation::SetLocalKeep:
+        _setLocalKeep();
+        _collectGarbageIfNeeded();
+        break;
+    case Operation::IncrementLocal:
+        _incrementLocal();
+        _collectGarbageIfNeeded();
+        break;
+    case Operation::JumpIfNotCompareLocals:
+        _jumpIfNotCompareLocals();
+        return;
+    case Operation::JumpIfNotCompareLocalConst:
+        _jumpIfNotCompareLocalConst();
+        return;
+    case Operation::GetArrayLocal:
+        _getArrayLocal();
+        break;
+    case Operation::GetArrayUnchecked:
+        _getArrayUnchecked();
+        break;
+    case Operation::GetArrayLocalUnchecked:
+        _getArrayLocalUnchecked();
+        break;
+    case Operation::SetArrayUnchecked:
+        _setArrayUnchecked();
+        _collectGarbageIfNeeded();
+        break;
+    case Operation::CheckBool:
+        _checkBool();
+        break;
+    case Operation::OperateLocal:
+        _operateLocal();
+        _collectGarbageIfNeeded();
+        break;
+    case Operation::OperateGlobal:
+        _operateGlobal();
+        _collectGarbageIfNeeded();
+        break;
+    case Operation::OperateArray:
+        _operateArray();
+        _collectGarbageIfNeeded();
+        break;
+    case Operation::AddInt:
+        _arithmeticQuickened(Operation::Add, Type::Int);
+        break;
+    case Operation::SubInt:
+        _arithmeticQuickened(Operation::Sub, Type::Int);
+        break;
+    case Operation::MulInt:
+        _arithmeticQuickened(Operation::Mul, Type::Int);
+        break;
+    case Operation::DivInt:
+        _arithmeticQuickened(Operation::Div, Type::Int);
+        break;
+    case Operation::AddFloat:
+        _arithmeticQuickened(Operation::Add, Type::Float);
+        break;
+    case Operation::SubFloat:
+        _arithmeticQuickened(Operation::Sub, Type::Float);
+        break;
+    case Operation::MulFloat:
+        _arithmeticQuickened(Operation::Mul, Type::Float);
+        break;
+    case Operation::DivFloat:
+        _arithmeticQuickened(Operation::Div, Type::Float);
+        break;
+    case Operation::LessInt:
+        _compareQuickened(Operation::Less, Type::Int, false);
+        return;
+    case Operation::MoreInt:
+        _compareQuickened(Operation::More, Type::Int, false);
+        return;
+    case Operation::LessOrEqInt:
+        _compareQuickened(Operation::LessOrEq, Type::Int, false);
+        return;
+    case Operation::MoreOrEqInt:
+        _compareQuickened(Operation::MoreOrEq, Type::Int, false);
+        return;
+    case Operation::LessFloat:
+        _compareQuickened(Operation::Less, Type::Float, false);
+        return;
+    case Operation::MoreFloat:
+        _compareQuickened(Operation::More, Type::Float, false);
+        return;
+    case Operation::LessOrEqFloat:
+        _compareQuickened(Operation::LessOrEq, Type::Float, false);
+        return;
+    case Operation::MoreOrEqFloat:
+        _compareQuickened(Operation::MoreOrEq, Type::Float, false);
+        return;
     case Operation::End:
         m_forcedEnd = true;
         break;
@@ -164,36 +302,457 @@ void GobLang::Machine::step()
     m_programCounter++;
 }
 
+// Interpreter loop used by run(). With computed goto every operation jumps directly to the handler of the next one,
+// otherwise a regular switch inside of the loop is used
+#ifdef GOB_LANG_USE_COMPUTED_GOTO
+#define GOB_OPERATION(name) op_##name:
+#define GOB_DISPATCH()                                                        \
+    if (!m_breakpoints.empty() && m_breakpoints.count(m_programCounter) > 0) \
+    {                                                                         \
+        return;                                                               \
+    }                                                                         \
+    goto *dispatchTable[std::min(m_operations[m_programCounter], invalidOperation)]
+#define GOB_INVALID_OPERATION() op_Invalid:
+#else
+#define GOB_OPERATION(name) case Operation::name:
+#define GOB_DISPATCH() break
+#define GOB_INVALID_OPERATION() default:
+#endif
+#define GOB_NEXT()          \
+    m_programCounter++; \
+    GOB_DISPATCH()
+
+void GobLang::Machine::run()
+{
+    // make sure that running past the last operation will always stop the machine
+    if (m_operations.empty() || m_operations.back() != (uint8_t)Operation::End)
+    {
+        m_operations.push_back((uint8_t)Operation::End);
+    }
+    if (isAtTheEnd())
+    {
+        return;
+    }
+#ifdef GOB_LANG_USE_COMPUTED_GOTO
+    // handlers are listed in the order of operations, with every byte after the last operation leading to the invalid operation handler.
+    // Table is constant, so it is built once during compilation instead of on every call
+    static void *const dispatchTable[] = {
+        &&op_None,
+        &&op_Add,
+        &&op_Sub,
+        &&op_Mul,
+        &&op_Div,
+        &&op_Modulo,
+        &&op_Call,
+        &&op_CallLocal,
+        &&op_CallNative,
+        &&op_Set,
+        &&op_Get,
+        &&op_SetGlobal,
+        &&op_GetGlobal,
+        &&op_GetLocal,
+        &&op_SetLocal,
+        &&op_GetArray,
+        &&op_SetArray,
+        &&op_PushConstInt,
+        &&op_PushConstUnsignedInt,
+        &&op_PushConstFloat,
+        &&op_PushConstChar,
+        &&op_PushConstString,
+        &&op_PushTrue,
+        &&op_PushFalse,
+        &&op_PushNull,
+        &&op_Equals,
+        &&op_Less,
+        &&op_More,
+        &&op_LessOrEq,
+        &&op_MoreOrEq,
+        &&op_NotEq,
+        &&op_And,
+        &&op_Or,
+        &&op_Not,
+        &&op_BitAnd,
+        &&op_BitOr,
+        &&op_BitXor,
+        &&op_BitNot,
+        &&op_ShiftLeft,
+        &&op_ShiftRight,
+        &&op_Negate,
+        &&op_Jump,
+        &&op_JumpIfNot,
+        &&op_JumpIf,
+        &&op_JumpIfNotOrPop,
+        &&op_JumpIfOrPop,
+        &&op_ShrinkLocal,
+        &&op_Return,
+        &&op_ReturnValue,
+        &&op_CreateArray,
+        &&op_SetLocalKeep,
+        &&op_IncrementLocal,
+        &&op_JumpIfNotCompareLocals,
+        &&op_JumpIfNotCompareLocalConst,
+        &&op_GetArrayLocal,
+        &&op_OperateLocal,
+        &&op_OperateGlobal,
+        &&op_OperateArray,
+        &&op_AddInt,
+        &&op_SubInt,
+        &&op_MulInt,
+        &&op_DivInt,
+        &&op_AddFloat,
+        &&op_SubFloat,
+        &&op_MulFloat,
+        &&op_DivFloat,
+        &&op_LessInt,
+        &&op_MoreInt,
+        &&op_LessOrEqInt,
+        &&op_MoreOrEqInt,
+        &&op_LessFloat,
+        &&op_MoreFloat,
+        &&op_LessOrEqFloat,
+        &&op_MoreOrEqFloat,
+        &&op_TailCallLocal,
+        &&op_GetArrayUnchecked,
+        &&op_GetArrayLocalUnchecked,
+        &&op_SetArrayUnchecked,
+        &&op_CheckBool,
+        &&op_End,
+        &&op_Invalid};
+    static_assert(sizeof(dispatchTable) / sizeof(dispatchTable[0]) == (size_t)Operation::End + 2, "Every operation must have a handler in the dispatch table");
+    constexpr uint8_t invalidOperation = (uint8_t)Operation::End + 1;
+    // first operation is executed even if there is a breakpoint on it, otherwise it would be impossible to continue
+    goto *dispatchTable[std::min(m_operations[m_programCounter], invalidOperation)];
+#else
+    while (true)
+    {
+        switch ((Operation)m_operations[m_programCounter])
+        {
+#endif
+    GOB_OPERATION(None)
+        GOB_NEXT();
+    GOB_OPERATION(Add)
+        _quicken(Operation::AddInt, Operation::AddFloat);
+        _add();
+        GOB_NEXT();
+    GOB_OPERATION(Sub)
+        _quicken(Operation::SubInt, Operation::SubFloat);
+        _sub();
+        GOB_NEXT();
+    GOB_OPERATION(Mul)
+        _quicken(Operation::MulInt, Operation::MulFloat);
+        _mul();
+        GOB_NEXT();
+    GOB_OPERATION(Div)
+        _quicken(Operation::DivInt, Operation::DivFloat);
+        _div();
+        GOB_NEXT();
+    GOB_OPERATION(Modulo)
+        _mod();
+        GOB_NEXT();
+    GOB_OPERATION(Call)
+        _call();
+        GOB_NEXT();
+    GOB_OPERATION(CallLocal)
+        _callLocal();
+        GOB_NEXT();
+    GOB_OPERATION(TailCallLocal)
+        _tailCallLocal();
+        _collectGarbageIfNeeded();
+        GOB_DISPATCH();
+    GOB_OPERATION(CallNative)
+        _callNative();
+        GOB_NEXT();
+    GOB_OPERATION(Set)
+        _set();
+        _collectGarbageIfNeeded();
+        GOB_NEXT();
+    GOB_OPERATION(Get)
+        _get();
+        GOB_NEXT();
+    GOB_OPERATION(SetGlobal)
+        _setGlobal();
+        _collectGarbageIfNeeded();
+        GOB_NEXT();
+    GOB_OPERATION(GetGlobal)
+        _getGlobal();
+        GOB_NEXT();
+    GOB_OPERATION(GetLocal)
+        _getLocal();
+        GOB_NEXT();
+    GOB_OPERATION(SetLocal)
+        _setLocal();
+        _collectGarbageIfNeeded();
+        GOB_NEXT();
+    GOB_OPERATION(GetArray)
+        _getArray();
+        GOB_NEXT();
+    GOB_OPERATION(SetArray)
+        _setArray();
+        _collectGarbageIfNeeded();
+        GOB_NEXT();
+    GOB_OPERATION(PushConstInt)
+        _pushConstInt();
+        GOB_NEXT();
+    GOB_OPERATION(PushConstUnsignedInt)
+        _pushConstUnsignedInt();
+        GOB_NEXT();
+    GOB_OPERATION(PushConstFloat)
+        _pushConstFloat();
+        GOB_NEXT();
+    GOB_OPERATION(PushConstChar)
+        _pushConstChar();
+        GOB_NEXT();
+    GOB_OPERATION(PushConstString)
+        _pushConstString();
+        GOB_NEXT();
+    GOB_OPERATION(PushTrue)
+        pushToStack(MemoryValue{.type = Type::Bool, .value = true});
+        GOB_NEXT();
+    GOB_OPERATION(PushFalse)
+        pushToStack(MemoryValue{.type = Type::Bool, .value = false});
+        GOB_NEXT();
+    GOB_OPERATION(PushNull)
+        _pushConstNull();
+        GOB_NEXT();
+    GOB_OPERATION(Equals)
+        _eq();
+        GOB_NEXT();
+    GOB_OPERATION(Less)
+        _quicken(Operation::LessInt, Operation::LessFloat);
+        _less();
+        GOB_NEXT();
+    GOB_OPERATION(More)
+        _quicken(Operation::MoreInt, Operation::MoreFloat);
+        _more();
+        GOB_NEXT();
+    GOB_OPERATION(LessOrEq)
+        _quicken(Operation::LessOrEqInt, Operation::LessOrEqFloat);
+        _lessOrEq();
+        GOB_NEXT();
+    GOB_OPERATION(MoreOrEq)
+        _quicken(Operation::MoreOrEqInt, Operation::MoreOrEqFloat);
+        _moreOrEq();
+        GOB_NEXT();
+    GOB_OPERATION(NotEq)
+        _neq();
+        GOB_NEXT();
+    GOB_OPERATION(And)
+        _and();
+        GOB_NEXT();
+    GOB_OPERATION(Or)
+        _or();
+        GOB_NEXT();
+    GOB_OPERATION(Not)
+        _not();
+        GOB_NEXT();
+    GOB_OPERATION(BitAnd)
+        _bitAnd();
+        GOB_NEXT();
+    GOB_OPERATION(BitOr)
+        _bitOr();
+        GOB_NEXT();
+    GOB_OPERATION(BitXor)
+        _bitXor();
+        GOB_NEXT();
+    GOB_OPERATION(BitNot)
+        _bitNot();
+        GOB_NEXT();
+    GOB_OPERATION(ShiftLeft)
+        _shiftLeft();
+        GOB_NEXT();
+    GOB_OPERATION(ShiftRight)
+        _shiftRight();
+        GOB_NEXT();
+    GOB_OPERATION(Negate)
+        _negate();
+        GOB_NEXT();
+    GOB_OPERATION(Jump)
+        _jump();
+        // loops end with a jump, so loops that only call functions and change counters still reach a point where garbage can be collected
+        _collectGarbageIfNeeded();
+        GOB_DISPATCH();
+    GOB_OPERATION(JumpIfNot)
+        _jumpIf();
+        GOB_DISPATCH();
+    GOB_OPERATION(JumpIf)
+        _jumpIfTrue();
+        GOB_DISPATCH();
+    GOB_OPERATION(JumpIfNotOrPop)
+        _jumpIfOrPop(false);
+        GOB_DISPATCH();
+    GOB_OPERATION(JumpIfOrPop)
+        _jumpIfOrPop(true);
+        GOB_DISPATCH();
+    GOB_OPERATION(ShrinkLocal)
+        _shrink();
+        _collectGarbageIfNeeded();
+        GOB_NEXT();
+    GOB_OPERATION(Return)
+        _return();
+        _collectGarbageIfNeeded();
+        GOB_NEXT();
+    GOB_OPERATION(ReturnValue)
+        _returnWithValue();
+        GOB_NEXT();
+    GOB_OPERATION(CreateArray)
+        _createArray();
+        GOB_NEXT();
+    GOB_OPERATION(SetLocalKeep)
+        _setLocalKeep();
+        _collectGarbageIfNeeded();
+        GOB_NEXT();
+    GOB_OPERATION(IncrementLocal)
+        _incrementLocal();
+        _collectGarbageIfNeeded();
+        GOB_NEXT();
+    GOB_OPERATION(JumpIfNotCompareLocals)
+        _jumpIfNotCompareLocals();
+        GOB_DISPATCH();
+    GOB_OPERATION(JumpIfNotCompareLocalConst)
+        _jumpIfNotCompareLocalConst();
+        GOB_DISPATCH();
+    GOB_OPERATION(GetArrayLocal)
+        _getArrayLocal();
+        GOB_NEXT();
+    GOB_OPERATION(GetArrayUnchecked)
+        _getArrayUnchecked();
+        GOB_NEXT();
+    GOB_OPERATION(GetArrayLocalUnchecked)
+        _getArrayLocalUnchecked();
+        GOB_NEXT();
+    GOB_OPERATION(SetArrayUnchecked)
+        _setArrayUnchecked();
+        _collectGarbageIfNeeded();
+        GOB_NEXT();
+    GOB_OPERATION(CheckBool)
+        _checkBool();
+        GOB_NEXT();
+    GOB_OPERATION(OperateLocal)
+        _operateLocal();
+        _collectGarbageIfNeeded();
+        GOB_NEXT();
+    GOB_OPERATION(OperateGlobal)
+        _operateGlobal();
+        _collectGarbageIfNeeded();
+        GOB_NEXT();
+    GOB_OPERATION(OperateArray)
+        _operateArray();
+        _collectGarbageIfNeeded();
+        GOB_NEXT();
+    GOB_OPERATION(AddInt)
+        _arithmeticQuickened(Operation::Add, Type::Int);
+        GOB_NEXT();
+    GOB_OPERATION(SubInt)
+        _arithmeticQuickened(Operation::Sub, Type::Int);
+        GOB_NEXT();
+    GOB_OPERATION(MulInt)
+        _arithmeticQuickened(Operation::Mul, Type::Int);
+        GOB_NEXT();
+    GOB_OPERATION(DivInt)
+        _arithmeticQuickened(Operation::Div, Type::Int);
+        GOB_NEXT();
+    GOB_OPERATION(AddFloat)
+        _arithmeticQuickened(Operation::Add, Type::Float);
+        GOB_NEXT();
+    GOB_OPERATION(SubFloat)
+        _arithmeticQuickened(Operation::Sub, Type::Float);
+        GOB_NEXT();
+    GOB_OPERATION(MulFloat)
+        _arithmeticQuickened(Operation::Mul, Type::Float);
+        GOB_NEXT();
+    GOB_OPERATION(DivFloat)
+        _arithmeticQuickened(Operation::Div, Type::Float);
+        GOB_NEXT();
+    GOB_OPERATION(LessInt)
+        _compareQuickened(Operation::Less, Type::Int, true);
+        GOB_DISPATCH();
+    GOB_OPERATION(MoreInt)
+        _compareQuickened(Operation::More, Type::Int, true);
+        GOB_DISPATCH();
+    GOB_OPERATION(LessOrEqInt)
+        _compareQuickened(Operation::LessOrEq, Type::Int, true);
+        GOB_DISPATCH();
+    GOB_OPERATION(MoreOrEqInt)
+        _compareQuickened(Operation::MoreOrEq, Type::Int, true);
+        GOB_DISPATCH();
+    GOB_OPERATION(LessFloat)
+        _compareQuickened(Operation::Less, Type::Float, true);
+        GOB_DISPATCH();
+    GOB_OPERATION(MoreFloat)
+        _compareQuickened(Operation::More, Type::Float, true);
+        GOB_DISPATCH();
+    GOB_OPERATION(LessOrEqFloat)
+        _compareQuickened(Operation::LessOrEq, Type::Float, true);
+        GOB_DISPATCH();
+    GOB_OPERATION(MoreOrEqFloat)
+        _compareQuickened(Operation::MoreOrEq, Type::Float, true);
+        GOB_DISPATCH();
+    GOB_OPERATION(End)
+        m_forcedEnd = true;
+        m_programCounter++;
+        return;
+    GOB_INVALID_OPERATION()
+        throw RuntimeException(std::string("Invalid op code: ") + std::to_string((int32_t)m_operations[m_programCounter]) + " at " + std::to_string(m_programCounter));
+#ifndef GOB_LANG_USE_COMPUTED_GOTO
+        }
+        if (!m_breakpoints.empty() && m_breakpoints.count(m_programCounter) > 0)
+        {
+            return;
+        }
+    }
+#endif
+}
+#undef GOB_OPERATION
+#undef GOB_DISPATCH
+#undef GOB_INVALID_OPERATION
+#undef GOB_NEXT
+
+void GobLang::Machine::addBreakpoint(size_t address)
+{
+    m_breakpoints.insert(address);
+}
+
+void GobLang::Machine::removeBreakpoint(size_t address)
+{
+    m_breakpoints.erase(address);
+}
+
 void GobLang::Machine::printGlobalsInfo()
 {
-    for (std::map<std::string, MemoryValue>::iterator it = m_globals.begin(); it != m_globals.end(); it++)
+    for (std::map<std::string, size_t>::iterator it = m_globalSlots.begin(); it != m_globalSlots.end(); it++)
     {
-        std::cout << it->first << "(" << typeToString(it->second.type) << ")" << " = " << valueToString(it->second, true) << std::endl;
+        if (!m_globalDefined[it->second])
+        {
+            continue;
+        }
+        MemoryValue const &val = m_globals[it->second];
+        std::cout << it->first << "(" << typeToString(val.type) << ")" << " = " << valueToString(val, true) << std::endl;
     }
 }
 
 void GobLang::Machine::printVariablesInfo()
 {
-    std::cout << "Local(" << m_variables.size() << "):" << std::endl;
-    for (std::vector<std::vector<MemoryValue>>::iterator layerIt = m_variables.begin(); layerIt != m_variables.end(); layerIt++)
+    std::cout << "Local(" << m_callStack.size() << "):" << std::endl;
+    for (std::vector<CallFrame>::iterator frameIt = m_callStack.begin(); frameIt != m_callStack.end(); frameIt++)
     {
-        std::cout << "Frame: " << layerIt - m_variables.begin() << std::endl;
-        for (std::vector<MemoryValue>::iterator it = layerIt->begin(); it != layerIt->end(); it++)
+        std::cout << "Frame: " << frameIt - m_callStack.begin() << std::endl;
+        for (size_t i = frameIt->localsBase; i < frameIt->operandBase; i++)
         {
-            std::cout << it - layerIt->begin() << ": " << typeToString(it->type) << " = " << valueToString(*it, true) << std::endl;
+            std::cout << i - frameIt->localsBase << ": " << typeToString(m_stack[i].type) << " = " << valueToString(m_stack[i], true) << std::endl;
         }
     }
 }
 
 void GobLang::Machine::printStack()
 {
-    std::cout << "Stack(" << m_operationStack.size() << "):" << std::endl;
-    for (std::vector<std::vector<MemoryValue>>::iterator layerIt = m_operationStack.begin(); layerIt != m_operationStack.end(); layerIt++)
+    std::cout << "Stack(" << m_callStack.size() << "):" << std::endl;
+    for (std::vector<CallFrame>::iterator frameIt = m_callStack.begin(); frameIt != m_callStack.end(); frameIt++)
     {
-        std::cout << "Frame: " << layerIt - m_operationStack.begin() << std::endl;
-        for (std::vector<MemoryValue>::reverse_iterator it = layerIt->rbegin(); it != layerIt->rend(); it++)
+        std::cout << "Frame: " << frameIt - m_callStack.begin() << std::endl;
+        size_t end = frameIt + 1 == m_callStack.end() ? m_stack.size() : (frameIt + 1)->localsBase;
+        for (size_t i = end; i > frameIt->operandBase; i--)
         {
-            std::cout << it - layerIt->rbegin() << ": " << typeToString(it->type) << " = " << valueToString(*it, true) << std::endl;
+            std::cout << end - i << ": " << typeToString(m_stack[i - 1].type) << " = " << valueToString(m_stack[i - 1], true) << std::endl;
         }
     }
 }
@@ -201,19 +760,19 @@ void GobLang::Machine::printStack()
 GobLang::MemoryValue *GobLang::Machine::getStackTop()
 
 {
-    if (m_operationStack.back().empty())
+    if (m_stack.size() <= m_callStack.back().operandBase)
     {
         return nullptr;
     }
     else
     {
-        return &m_operationStack.back()[m_operationStack.size() - 1];
+        return &m_stack.back();
     }
 }
 
 GobLang::MemoryValue *GobLang::Machine::getStackTopAndPop()
 {
-    if (m_operationStack.back().empty())
+    if (m_stack.size() <= m_callStack.back().operandBase)
     {
         return nullptr;
     }
@@ -226,150 +785,147 @@ GobLang::MemoryValue *GobLang::Machine::getStackTopAndPop()
 
 GobLang::ArrayNode *GobLang::Machine::createArrayOfSize(int32_t size)
 {
-    ArrayNode *node = new ArrayNode(size);
-    m_memoryRoot.pushBack(node);
-    return node;
+    return m_heap.create<ArrayNode>(size);
 }
 
 GobLang::StringNode *GobLang::Machine::createString(std::string const &str, bool alwaysNew)
 {
-    MemoryNode *root = &m_memoryRoot;
-    StringNode *node = nullptr;
     // avoid making instance for each call, check if there is anything that uses this already
-    while (root != nullptr && !alwaysNew)
+    if (!alwaysNew)
     {
-        if (StringNode *strNode = dynamic_cast<StringNode *>(root); strNode != nullptr && strNode->getString() == str)
+        std::pair<std::unordered_multimap<size_t, StringNode *>::iterator, std::unordered_multimap<size_t, StringNode *>::iterator> range =
+            m_internedStrings.equal_range(std::hash<std::string>{}(str));
+        for (std::unordered_multimap<size_t, StringNode *>::iterator it = range.first; it != range.second; it++)
         {
-            node = strNode;
-            break;
+            if (it->second->getString() == str)
+            {
+                return it->second;
+            }
         }
-        root = root->getNext();
     }
-    if (node == nullptr)
+    StringNode *node = m_heap.create<StringNode>(str);
+    if (!alwaysNew)
     {
-        node = new StringNode(str);
-        m_memoryRoot.pushBack(node);
+        node->setInterned(true);
+        m_internedStrings.emplace(node->getHash(), node);
     }
     return node;
 }
 
 void GobLang::Machine::addObject(MemoryNode *obj)
 {
-    m_memoryRoot.pushBack(obj);
+    m_heap.addForeign(obj);
 }
 
 void GobLang::Machine::popStack()
 {
-    m_operationStack.back().pop_back();
+    m_stack.pop_back();
 }
 
 void GobLang::Machine::pushToStack(MemoryValue const &val)
 {
-    m_operationStack.back().push_back(val);
+    m_stack.push_back(val);
 }
 
 void GobLang::Machine::setLocalVariableValue(size_t id, MemoryValue const &val)
 {
-    std::vector<MemoryValue> &varFrame = m_variables.back();
-    if (id >= varFrame.size())
-    {
-        varFrame.resize(id + 1);
-    }
-    if (val.type == Type::MemoryObj)
-    {
-        std::get<MemoryNode *>(val.value)->increaseRefCount();
-    }
-    if (varFrame[id].type == Type::MemoryObj)
+    CallFrame &frame = m_callStack.back();
+    if (id >= frame.operandBase - frame.localsBase)
     {
-        std::get<MemoryNode *>(varFrame[id].value)->decreaseRefCount();
+        // local variables are placed before operation stack so values of the operation stack have to be moved
+        size_t extra = id + 1 - (frame.operandBase - frame.localsBase);
+        m_stack.insert(m_stack.begin() + frame.operandBase, extra, MemoryValue{.type = Type::Null, .value = 0});
+        frame.operandBase += extra;
     }
-    varFrame[id] = val;
+    m_stack[frame.localsBase + id] = val;
 }
 
 GobLang::MemoryValue *GobLang::Machine::getLocalVariableValue(size_t id)
 {
-    if (m_variables.back().size() < id)
+    CallFrame const &frame = m_callStack.back();
+    if (id >= frame.operandBase - frame.localsBase)
     {
         return nullptr;
     }
-    return &m_variables.back()[id];
+    return &m_stack[frame.localsBase + id];
 }
 
-void GobLang::Machine::shrinkLocalVariableStackBy(size_t size)
+GobLang::MemoryValue *GobLang::Machine::_getExistingLocal(size_t id)
 {
-    size_t i = 0;
-    for (std::vector<MemoryValue>::reverse_iterator it = m_variables.back().rbegin(); it != m_variables.back().rend() && i < size; it++, i++)
+    MemoryValue *val = getLocalVariableValue(id);
+    if (val == nullptr)
     {
-        if (it->type == Type::MemoryObj)
-        {
-            std::get<MemoryNode *>(it->value)->decreaseRefCount();
-        }
+        throw RuntimeException(std::string("Attempted to retrieve value of variable ") + std::to_string(id) + ", but no variable uses this id");
     }
-    // possibly add m_variables.resize(m_variables.size() - size)
+    return val;
+}
+
+void GobLang::Machine::shrinkLocalVariableStackBy(size_t size)
+{
+    CallFrame &frame = m_callStack.back();
+    size = std::min(size, frame.operandBase - frame.localsBase);
+    m_stack.erase(m_stack.begin() + (frame.operandBase - size), m_stack.begin() + frame.operandBase);
+    frame.operandBase -= size;
 }
 
 void GobLang::Machine::removeFunctionFrame()
 {
-    if (m_variables.size() == 1)
+    if (m_callStack.size() == 1)
     {
         throw RuntimeException("Attempted to remove root variable stack frame");
     }
-    std::vector<MemoryValue> &frame = m_variables.back();
-    for (std::vector<MemoryValue>::const_iterator it = frame.begin(); it != frame.end(); it++)
-    {
-        if (it->type == Type::MemoryObj)
-        {
-            std::get<MemoryNode *>(it->value)->decreaseRefCount();
-        }
-    }
-    m_variables.pop_back();
-    std::vector<MemoryValue> &stackFrame = m_operationStack.back();
-    for (std::vector<MemoryValue>::const_iterator it = stackFrame.begin(); it != stackFrame.end(); it++)
+    m_stack.resize(m_callStack.back().localsBase);
+    m_callStack.pop_back();
+}
+
+GobLang::MemoryValue GobLang::Machine::getVariableValue(std::string const &name)
+{
+    std::map<std::string, size_t>::const_iterator it = m_globalSlots.find(name);
+    if (it == m_globalSlots.end())
     {
-        if (it->type == Type::MemoryObj)
-        {
-            std::get<MemoryNode *>(it->value)->decreaseRefCount();
-        }
+        return MemoryValue{.type = Type::Null, .value = 0};
     }
-    m_operationStack.pop_back();
+    return m_globals[it->second];
 }
 
 void GobLang::Machine::createVariable(std::string const &name, MemoryValue const &value)
 {
-    m_globals[name] = value;
+    _setGlobalValue(_getGlobalSlot(name), value);
 }
 
-void GobLang::Machine::collectGarbage()
+void GobLang::Machine::collect()
 {
-    MemoryNode *prev = &m_memoryRoot;
-    MemoryNode *curr = m_memoryRoot.getNext();
-    while (curr != nullptr)
+    MemoryTracer tracer;
+    // all values used by the code are either stored in the value stack or in global variables
+    for (std::vector<MemoryValue>::const_iterator it = m_stack.begin(); it != m_stack.end(); it++)
     {
-        if (!curr->isDead())
+        tracer.mark(*it);
+    }
+    for (std::vector<MemoryValue>::const_iterator it = m_globals.begin(); it != m_globals.end(); it++)
+    {
+        tracer.mark(*it);
+    }
+    m_heap.markPinned(tracer);
+    tracer.traceAll();
+    m_heap.sweep(
+        [this](MemoryNode *node)
         {
-            prev = curr;
-            curr = curr->getNext();
-            continue;
-        }
-        // if we are deleting then prev should stay the same while
-        // curr gets deleted
-        MemoryNode *del = curr;
-        prev->eraseNext();
-        curr = prev->getNext();
+            if (StringNode *strNode = node->as<StringNode>(); strNode != nullptr)
+            {
+                _removeInternedString(strNode);
+            }
+        });
+    size_t allowedGrowth = (size_t)(m_heap.getObjectCount() * std::max(m_gcPolicy.growthFactor - 1.f, 0.f));
+    m_nextCollectionAllocation = m_heap.getAllocationCount() + std::max(m_gcPolicy.minThreshold, allowedGrowth);
+}
 
-        delete del;
-    }
+void GobLang::Machine::setGcPolicy(GcPolicy const &policy)
+{
+    m_gcPolicy = policy;
 }
 
 GobLang::Machine::~Machine()
 {
-    MemoryNode *root = m_memoryRoot.getNext();
-    while (root != nullptr)
-    {
-        MemoryNode *del = root;
-        root = root->getNext();
-        delete del;
-    }
 }
 
 GobLang::ProgramAddressType GobLang::Machine::_getAddressFromByteCode(size_t start)
@@ -383,6 +939,69 @@ GobLang::ProgramAddressType GobLang::Machine::_getAddressFromByteCode(size_t sta
     return reconAddr;
 }
 
+size_t GobLang::Machine::_getGlobalSlot(std::string const &name)
+{
+    std::map<std::string, size_t>::const_iterator it = m_globalSlots.find(name);
+    if (it != m_globalSlots.end())
+    {
+        return it->second;
+    }
+    size_t slot = m_globals.size();
+    m_globals.push_back(MemoryValue{.type = Type::Null, .value = 0});
+    m_globalDefined.push_back(false);
+    m_globalNames.push_back(name);
+    m_globalSlots[name] = slot;
+    return slot;
+}
+
+void GobLang::Machine::_setGlobalValue(size_t slot, MemoryValue const &val)
+{
+    m_globals[slot] = val;
+    m_globalDefined[slot] = true;
+}
+
+size_t GobLang::Machine::_getNativeFunctionId(std::string const &name)
+{
+    std::map<std::string, size_t>::const_iterator it = m_nativeFunctionIds.find(name);
+    if (it != m_nativeFunctionIds.end())
+    {
+        return it->second;
+    }
+    size_t id = m_nativeFunctions.size();
+    m_nativeFunctions.push_back(FunctionValue());
+    m_nativeFunctionNames.push_back(name);
+    m_nativeFunctionIds[name] = id;
+    return id;
+}
+
+void GobLang::Machine::_invokeNativeFunction(size_t id)
+{
+    if (id >= m_nativeFunctions.size() || !m_nativeFunctions[id])
+    {
+        throw RuntimeException(std::string("Attempted to call native function '") + (id < m_nativeFunctionNames.size() ? m_nativeFunctionNames[id] : std::to_string(id)) + "', but no function was bound to it");
+    }
+    m_nativeFunctions[id](this);
+}
+
+void GobLang::Machine::_removeInternedString(StringNode *str)
+{
+    if (!str->isInterned())
+    {
+        return;
+    }
+    std::pair<std::unordered_multimap<size_t, StringNode *>::iterator, std::unordered_multimap<size_t, StringNode *>::iterator> range =
+        m_internedStrings.equal_range(str->getHash());
+    for (std::unordered_multimap<size_t, StringNode *>::iterator it = range.first; it != range.second; it++)
+    {
+        if (it->second == str)
+        {
+            m_internedStrings.erase(it);
+            break;
+        }
+    }
+    str->setInterned(false);
+}
+
 void GobLang::Machine::_jump()
 {
     ProgramAddressType dest = _getAddressFromByteCode(m_programCounter + 1);
@@ -396,7 +1015,7 @@ void GobLang::Machine::_jumpIf()
     MemoryValue a = _getFromTopAndPop();
     if (a.type == Type::Bool)
     {
-        if (!std::get<bool>(a.value))
+        if (!a.value.boolean)
         {
             m_programCounter = dest;
         }
@@ -411,6 +1030,51 @@ void GobLang::Machine::_jumpIf()
     }
 }
 
+void GobLang::Machine::_jumpIfTrue()
+{
+    MemoryValue a = _getFromTopAndPop();
+    if (a.type != Type::Bool)
+    {
+        throw RuntimeException(std::string("Invalid data type passed to condition check. Expected bool got: ") + typeToString(a.type));
+    }
+    if (a.value.boolean)
+    {
+        m_programCounter = _getAddressFromByteCode(m_programCounter + 1);
+    }
+    else
+    {
+        m_programCounter += 1 + sizeof(ProgramAddressType);
+    }
+}
+
+void GobLang::Machine::_checkBool()
+{
+    MemoryValue const &a = m_stack.back();
+    if (a.type != Type::Bool)
+    {
+        throw RuntimeException(std::string("Invalid data type passed to condition check. Expected bool got: ") + typeToString(a.type));
+    }
+}
+
+void GobLang::Machine::_jumpIfOrPop(bool jumpValue)
+{
+    MemoryValue const &a = m_stack.back();
+    if (a.type != Type::Bool)
+    {
+        throw RuntimeException(std::string("Invalid data type passed to condition check. Expected bool got: ") + typeToString(a.type));
+    }
+    ProgramAddressType offset = _getAddressFromByteCode(m_programCounter + 1);
+    m_programCounter += 1 + sizeof(ProgramAddressType);
+    if (a.value.boolean == jumpValue)
+    {
+        m_programCounter += offset;
+    }
+    else
+    {
+        popStack();
+    }
+}
+
 void GobLang::Machine::_add()
 {
     MemoryValue b = _getFromTopAndPop();
@@ -423,22 +1087,23 @@ void GobLang::Machine::_add()
     switch (a.type)
     {
     case Type::Int:
-        c = std::get<int32_t>(a.value) + std::get<int32_t>(b.value);
+        c = a.value.integer + b.value.integer;
         break;
     case Type::UnsignedInt:
-        c = std::get<uint32_t>(a.value) + std::get<uint32_t>(b.value);
+        c = a.value.unsignedInteger + b.value.unsignedInteger;
         break;
     case Type::Float:
-        c = std::get<float>(a.value) + std::get<float>(b.value);
+        c = a.value.floating + b.value.floating;
         break;
     case Type::MemoryObj:
     {
-        StringNode *str1 = dynamic_cast<StringNode *>(std::get<MemoryNode *>(a.value));
-        StringNode *str2 = dynamic_cast<StringNode *>(std::get<MemoryNode *>(b.value));
-        if (str1 != nullptr && str2 != nullptr)
+        StringNode *str1 = a.value.object->as<StringNode>();
+        StringNode *str2 = b.value.object->as<StringNode>();
+        if (str1 == nullptr || str2 == nullptr)
         {
-            c = createString(str1->getString() + str2->getString());
+            throw RuntimeException("Attempted to add objects that are not strings");
         }
+        c = createString(str1->getString() + str2->getString());
     }
     break;
     default:
@@ -459,13 +1124,13 @@ void GobLang::Machine::_sub()
     switch (a.type)
     {
     case Type::Int:
-        c = std::get<int32_t>(b.value) - std::get<int32_t>(a.value);
+        c = b.value.integer - a.value.integer;
         break;
     case Type::UnsignedInt:
-        c = std::get<uint32_t>(b.value) - std::get<uint32_t>(a.value);
+        c = b.value.unsignedInteger - a.value.unsignedInteger;
         break;
     case Type::Float:
-        c = std::get<float>(b.value) - std::get<float>(a.value);
+        c = b.value.floating - a.value.floating;
         break;
     default:
         throw RuntimeException(std::string("Invalid type used for math operation") + typeToString(a.type));
@@ -485,13 +1150,13 @@ void GobLang::Machine::_mul()
     switch (a.type)
     {
     case Type::Int:
-        c = std::get<int32_t>(b.value) * std::get<int32_t>(a.value);
+        c = b.value.integer * a.value.integer;
         break;
     case Type::UnsignedInt:
-        c = std::get<uint32_t>(b.value) * std::get<uint32_t>(a.value);
+        c = b.value.unsignedInteger * a.value.unsignedInteger;
         break;
     case Type::Float:
-        c = std::get<float>(b.value) * std::get<float>(a.value);
+        c = b.value.floating * a.value.floating;
         break;
     default:
         throw RuntimeException(std::string("Invalid type used for math operation") + typeToString(a.type));
@@ -507,17 +1172,18 @@ void GobLang::Machine::_div()
     {
         throw RuntimeException(std::string("Attempted to add values of ") + typeToString(a.type) + " and " + typeToString(b.type));
     }
+    _checkDivision(b, a);
     Value c;
     switch (a.type)
     {
     case Type::Int:
-        c = std::get<int32_t>(b.value) / std::get<int32_t>(a.value);
+        c = b.value.integer / a.value.integer;
         break;
     case Type::UnsignedInt:
-        c = std::get<uint32_t>(b.value) / std::get<uint32_t>(a.value);
+        c = b.value.unsignedInteger / a.value.unsignedInteger;
         break;
     case Type::Float:
-        c = std::get<float>(b.value) / std::get<float>(a.value);
+        c = b.value.floating / a.value.floating;
         break;
     default:
         throw RuntimeException(std::string("Invalid type used for math operation") + typeToString(a.type));
@@ -525,6 +1191,19 @@ void GobLang::Machine::_div()
     pushToStack(MemoryValue{.type = a.type, .value = c});
 }
 
+void GobLang::Machine::_checkDivision(MemoryValue const &dividend, MemoryValue const &divisor) const
+{
+    if ((divisor.type == Type::Int && divisor.value.integer == 0) ||
+        (divisor.type == Type::UnsignedInt && divisor.value.unsignedInteger == 0))
+    {
+        throw RuntimeException("Attempted to divide by zero");
+    }
+    if (dividend.type == Type::Int && divisor.type == Type::Int && dividend.value.integer == INT32_MIN && divisor.value.integer == -1)
+    {
+        throw RuntimeException("Result of division doesn't fit into int");
+    }
+}
+
 inline void GobLang::Machine::_mod()
 {
     MemoryValue a = _getFromTopAndPop();
@@ -533,13 +1212,14 @@ inline void GobLang::Machine::_mod()
     {
         throw RuntimeException("Type mismatch in modulo operation");
     }
+    _checkDivision(b, a);
     switch (a.type)
     {
     case Type::Int:
-        pushToStack(MemoryValue{.type = Type::Int, .value = std::get<int32_t>(b.value) % std::get<int32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::Int, .value = b.value.integer % a.value.integer});
         break;
     case Type::UnsignedInt:
-        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = std::get<uint32_t>(b.value) % std::get<uint32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = b.value.unsignedInteger % a.value.unsignedInteger});
         break;
     default:
         throw RuntimeException("Modulo can only be used on int or unsigned int");
@@ -555,36 +1235,51 @@ void GobLang::Machine::_set()
     // (name val =)
     MemoryValue val = _getFromTopAndPop();
     MemoryValue name = _getFromTopAndPop();
-    StringNode *memStr = dynamic_cast<StringNode *>(std::get<MemoryNode *>(name.value));
+    StringNode *memStr = getValueObject<StringNode>(name);
     if (memStr != nullptr)
     {
-        if (val.type == Type::MemoryObj)
-        {
-            std::get<MemoryNode *>(val.value)->increaseRefCount();
-        }
-        if (m_globals.count(memStr->getString()) > 0 && m_globals[memStr->getString()].type == Type::MemoryObj)
-        {
-            std::get<MemoryNode *>(m_globals[memStr->getString()].value)->decreaseRefCount();
-        }
-        m_globals[memStr->getString()] = val;
+        _setGlobalValue(_getGlobalSlot(memStr->getString()), val);
     }
 }
 
 void GobLang::Machine::_get()
 {
     MemoryValue name = _getFromTopAndPop();
-    assert(std::holds_alternative<MemoryNode *>(name.value));
-    StringNode *memStr = dynamic_cast<StringNode *>(std::get<MemoryNode *>(name.value));
+    assert(name.type == Type::MemoryObj);
+    StringNode *memStr = getValueObject<StringNode>(name);
     if (memStr != nullptr)
     {
-        if (m_globals.count(memStr->getString()) < 1)
+        std::map<std::string, size_t>::const_iterator it = m_globalSlots.find(memStr->getString());
+        if (it == m_globalSlots.end() || !m_globalDefined[it->second])
         {
             throw RuntimeException(std::string("Attempted to get variable '" + memStr->getString() + "', which doesn't exist"));
         }
-        pushToStack(m_globals[memStr->getString()]);
+        pushToStack(m_globals[it->second]);
     }
 }
 
+void GobLang::Machine::_setGlobal()
+{
+    size_t slot = m_operations[m_programCounter + 1];
+    m_programCounter++;
+    if (slot >= m_globals.size())
+    {
+        throw RuntimeException(std::string("Attempted to set global variable using invalid slot ") + std::to_string(slot));
+    }
+    _setGlobalValue(slot, _getFromTopAndPop());
+}
+
+void GobLang::Machine::_getGlobal()
+{
+    size_t slot = m_operations[m_programCounter + 1];
+    m_programCounter++;
+    if (slot >= m_globals.size() || !m_globalDefined[slot])
+    {
+        throw RuntimeException(std::string("Attempted to get variable '") + (slot < m_globalNames.size() ? m_globalNames[slot] : std::to_string(slot)) + "', which doesn't exist");
+    }
+    pushToStack(m_globals[slot]);
+}
+
 inline void GobLang::Machine::_bitAnd()
 {
     MemoryValue a = _getFromTopAndPop();
@@ -596,10 +1291,10 @@ inline void GobLang::Machine::_bitAnd()
     switch (a.type)
     {
     case Type::Int:
-        pushToStack(MemoryValue{.type = Type::Int, .value = std::get<int32_t>(b.value) & std::get<int32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::Int, .value = b.value.integer & a.value.integer});
         break;
     case Type::UnsignedInt:
-        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = std::get<uint32_t>(b.value) & std::get<uint32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = b.value.unsignedInteger & a.value.unsignedInteger});
         break;
     default:
         throw RuntimeException("Modulo can only be used on int or unsigned int");
@@ -617,10 +1312,10 @@ inline void GobLang::Machine::_bitOr()
     switch (a.type)
     {
     case Type::Int:
-        pushToStack(MemoryValue{.type = Type::Int, .value = std::get<int32_t>(b.value) | std::get<int32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::Int, .value = b.value.integer | a.value.integer});
         break;
     case Type::UnsignedInt:
-        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = std::get<uint32_t>(b.value) | std::get<uint32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = b.value.unsignedInteger | a.value.unsignedInteger});
         break;
     default:
         throw RuntimeException("Modulo can only be used on int or unsigned int");
@@ -638,10 +1333,10 @@ inline void GobLang::Machine::_bitXor()
     switch (a.type)
     {
     case Type::Int:
-        pushToStack(MemoryValue{.type = Type::Int, .value = std::get<int32_t>(b.value) ^ std::get<int32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::Int, .value = b.value.integer ^ a.value.integer});
         break;
     case Type::UnsignedInt:
-        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = std::get<uint32_t>(b.value) ^ std::get<uint32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = b.value.unsignedInteger ^ a.value.unsignedInteger});
         break;
     default:
         throw RuntimeException("Modulo can only be used on int or unsigned int");
@@ -654,10 +1349,10 @@ inline void GobLang::Machine::_bitNot()
     switch (a.type)
     {
     case Type::Int:
-        pushToStack(MemoryValue{.type = Type::Int, .value = ~std::get<int32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::Int, .value = ~a.value.integer});
         break;
     case Type::UnsignedInt:
-        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = ~std::get<uint32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = ~a.value.unsignedInteger});
         break;
     default:
         throw RuntimeException(std::string("Attempted to bit NOT value of  ") + typeToString(a.type) + ". Only int or unsigned int is allowed");
@@ -675,10 +1370,10 @@ inline void GobLang::Machine::_shiftLeft()
     switch (a.type)
     {
     case Type::Int:
-        pushToStack(MemoryValue{.type = Type::Int, .value = std::get<int32_t>(b.value) << std::get<int32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::Int, .value = b.value.integer << a.value.integer});
         break;
     case Type::UnsignedInt:
-        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = std::get<uint32_t>(b.value) << std::get<uint32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = b.value.unsignedInteger << a.value.unsignedInteger});
         break;
     default:
         throw RuntimeException("Modulo can only be used on int or unsigned int");
@@ -696,10 +1391,10 @@ inline void GobLang::Machine::_shiftRight()
     switch (a.type)
     {
     case Type::Int:
-        pushToStack(MemoryValue{.type = Type::Int, .value = std::get<int32_t>(b.value) >> std::get<int32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::Int, .value = b.value.integer >> a.value.integer});
         break;
     case Type::UnsignedInt:
-        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = std::get<uint32_t>(b.value) >> std::get<uint32_t>(a.value)});
+        pushToStack(MemoryValue{.type = Type::UnsignedInt, .value = b.value.unsignedInteger >> a.value.unsignedInteger});
         break;
     default:
         throw RuntimeException("Modulo can only be used on int or unsigned int");
@@ -714,26 +1409,27 @@ void GobLang::Machine::_setLocal()
     setLocalVariableValue(id, val);
 }
 
-void GobLang::Machine::_getLocal()
+void GobLang::Machine::_setLocalKeep()
 {
     m_programCounter++;
     uint8_t id = m_operations[m_programCounter];
-    if (MemoryValue *val = getLocalVariableValue(id); val != nullptr)
-    {
-        pushToStack(*val);
-    }
-    else
-    {
-        throw RuntimeException(std::string("Attempted to retrieve value of variable ") + std::to_string(id) + ", but no variable uses this id");
-    }
+    // value stays on the stack, so it has to be copied because stack can be moved when new local is added
+    MemoryValue val = _operationTop();
+    setLocalVariableValue(id, val);
+}
+
+void GobLang::Machine::_getLocal()
+{
+    m_programCounter++;
+    pushToStack(*_getExistingLocal(m_operations[m_programCounter]));
 }
 
 void GobLang::Machine::_call()
 {
     MemoryValue func = _getFromTopAndPop();
-    if (std::holds_alternative<FunctionValue>(func.value))
+    if (func.type == Type::NativeFunction)
     {
-        std::get<FunctionValue>(func.value)(this);
+        _invokeNativeFunction(func.value.nativeFunction);
     }
     else
     {
@@ -744,38 +1440,60 @@ void GobLang::Machine::_call()
 void GobLang::Machine::_callLocal()
 {
     size_t funcId = (size_t)m_operations[m_programCounter + 1];
-    m_callStack.push_back(m_programCounter + 1);
+    size_t argCount = m_functions[funcId].arguments.size();
+    if (m_stack.size() - m_callStack.back().operandBase < argCount)
+    {
+        throw RuntimeException(std::string("Not enough values on the stack to call function. Expected ") + std::to_string(argCount));
+    }
+    // arguments are already on top of the stack in the correct order, so they simply become first local variables of the new frame
+    m_callStack.push_back(CallFrame{
+        .returnAddress = m_programCounter + 1,
+        .localsBase = m_stack.size() - argCount,
+        .operandBase = m_stack.size()});
     m_programCounter = m_functions[funcId].start - 1;
-    std::vector<MemoryValue> args = std::vector<MemoryValue>(m_functions[funcId].arguments.size());
+}
 
-    std::vector<MemoryValue> &variableFrame = m_variables.back();
+void GobLang::Machine::_tailCallLocal()
+{
+    size_t funcId = (size_t)m_operations[m_programCounter + 1];
+    size_t argCount = m_functions[funcId].arguments.size();
+    CallFrame &frame = m_callStack.back();
+    if (m_stack.size() - frame.operandBase < argCount)
+    {
+        throw RuntimeException(std::string("Not enough values on the stack to call function. Expected ") + std::to_string(argCount));
+    }
+    if (m_callStack.size() == 1)
+    {
+        throw RuntimeException("Attempted to remove root variable stack frame");
+    }
+    // arguments replace local variables of the current function and the call returns to where the current function was called from
+    std::copy(m_stack.end() - argCount, m_stack.end(), m_stack.begin() + frame.localsBase);
+    m_stack.resize(frame.localsBase + argCount);
+    frame.operandBase = m_stack.size();
+    m_programCounter = m_functions[funcId].start;
+}
 
-    for (std::vector<MemoryValue>::reverse_iterator it = args.rbegin(); it != args.rend(); it++)
+void GobLang::Machine::_callNative()
+{
+    size_t id = m_operations[m_programCounter + 1];
+    size_t argCount = m_operations[m_programCounter + 2];
+    m_programCounter += 2;
+    if (m_stack.size() - m_callStack.back().operandBase < argCount)
     {
-        *it = _getFromTopAndPop();
-        // for the entirety of the value being in the function we assume that it is in use so we can not delete it
-        if (it->type == Type::MemoryObj)
-        {
-            std::get<MemoryNode *>(it->value)->increaseRefCount();
-        }
+        throw RuntimeException(std::string("Not enough values on the stack to call function. Expected ") + std::to_string(argCount));
     }
-    m_variables.push_back(args);
-    m_operationStack.push_back({});
+    _invokeNativeFunction(id);
 }
 
 void GobLang::Machine::_return()
 {
-    size_t pos = m_callStack.back();
-    m_callStack.pop_back();
-    m_programCounter = pos;
+    m_programCounter = m_callStack.back().returnAddress;
     removeFunctionFrame();
 }
 
 void GobLang::Machine::_returnWithValue()
 {
-    size_t pos = m_callStack.back();
-    m_callStack.pop_back();
-    m_programCounter = pos;
+    m_programCounter = m_callStack.back().returnAddress;
     // we have to remove it manually to avoid it getting grabbed by the garbage collector
     MemoryValue returnVal = _getFromTopAndPop();
     removeFunctionFrame();
@@ -828,22 +1546,82 @@ void GobLang::Machine::_getArray()
 {
     MemoryValue array = _getFromTopAndPop();
     MemoryValue index = _getFromTopAndPop();
-    if (!std::holds_alternative<MemoryNode *>(array.value))
+    _pushArrayItem(array, index);
+}
+
+void GobLang::Machine::_getArrayLocal()
+{
+    m_programCounter++;
+    MemoryValue index = _getFromTopAndPop();
+    _pushArrayItem(*_getExistingLocal(m_operations[m_programCounter]), index);
+}
+
+void GobLang::Machine::_pushArrayItem(MemoryValue const &array, MemoryValue const &index)
+{
+    if (array.type != Type::MemoryObj)
     {
         throw RuntimeException(std::string("Attempted to get array value, but array has instead type: ") + typeToString(array.type));
     }
-    if (!std::holds_alternative<int32_t>(index.value))
+    if (index.type != Type::Int)
     {
         throw RuntimeException(std::string("Attempted to get array value, but index has instead type: ") + typeToString(array.type));
     }
-    if (ArrayNode *arrNode = dynamic_cast<ArrayNode *>(std::get<MemoryNode *>(array.value)); arrNode != nullptr)
+    if (ArrayNode *arrNode = array.value.object->as<ArrayNode>(); arrNode != nullptr)
+    {
+        pushToStack(*arrNode->getItem(index.value.integer));
+    }
+    else if (StringNode *strNode = array.value.object->as<StringNode>(); strNode != nullptr)
+    {
+        pushToStack(MemoryValue{.type = Type::Char, .value = strNode->getCharAt(index.value.integer)});
+    }
+    else
+    {
+        throw RuntimeException("Attempted to get array value, but object is neither array nor string");
+    }
+}
+
+void GobLang::Machine::_getArrayUnchecked()
+{
+    MemoryValue array = _getFromTopAndPop();
+    MemoryValue index = _getFromTopAndPop();
+    _pushArrayItemUnchecked(array, index);
+}
+
+void GobLang::Machine::_getArrayLocalUnchecked()
+{
+    m_programCounter++;
+    MemoryValue index = _getFromTopAndPop();
+    _pushArrayItemUnchecked(*_getExistingLocal(m_operations[m_programCounter]), index);
+}
+
+void GobLang::Machine::_pushArrayItemUnchecked(MemoryValue const &array, MemoryValue const &index)
+{
+    // compiler only knows the size of the value, which could also be a string
+    if (array.type == Type::MemoryObj)
     {
-        pushToStack(*arrNode->getItem(std::get<int32_t>(index.value)));
+        if (ArrayNode *arrNode = array.value.object->as<ArrayNode>(); arrNode != nullptr)
+        {
+            pushToStack(*arrNode->getItemUnchecked(index.value.integer));
+            return;
+        }
     }
-    else if (StringNode *strNode = dynamic_cast<StringNode *>(std::get<MemoryNode *>(array.value)); strNode != nullptr)
+    _pushArrayItem(array, index);
+}
+
+void GobLang::Machine::_setArrayUnchecked()
+{
+    MemoryValue value = _getFromTopAndPop();
+    MemoryValue array = _getFromTopAndPop();
+    MemoryValue index = _getFromTopAndPop();
+    if (array.type == Type::MemoryObj)
     {
-        pushToStack(MemoryValue{.type = Type::Char, .value = strNode->getCharAt(std::get<int32_t>(index.value))});
+        if (ArrayNode *arrNode = array.value.object->as<ArrayNode>(); arrNode != nullptr)
+        {
+            arrNode->setItemUnchecked(index.value.integer, value);
+            return;
+        }
     }
+    _setArrayItem(array, index, value);
 }
 
 void GobLang::Machine::_setArray()
@@ -851,22 +1629,29 @@ void GobLang::Machine::_setArray()
     MemoryValue value = _getFromTopAndPop();
     MemoryValue array = _getFromTopAndPop();
     MemoryValue index = _getFromTopAndPop();
-    if (!std::holds_alternative<MemoryNode *>(array.value))
+    _setArrayItem(array, index, value);
+}
+
+void GobLang::Machine::_setArrayItem(MemoryValue const &array, MemoryValue const &index, MemoryValue const &value)
+{
+    if (array.type != Type::MemoryObj)
     {
         throw RuntimeException(std::string("Attempted to set array value, but array has instead type: ") + typeToString(array.type));
     }
-    if (!std::holds_alternative<int32_t>(index.value))
+    if (index.type != Type::Int)
     {
         throw RuntimeException(std::string("Attempted to set array value, but index has instead type: ") + typeToString(array.type));
     }
-    MemoryNode *m = std::get<MemoryNode *>(array.value);
-    if (ArrayNode *arrNode = dynamic_cast<ArrayNode *>(m); arrNode != nullptr)
+    MemoryNode *m = array.value.object;
+    if (ArrayNode *arrNode = m->as<ArrayNode>(); arrNode != nullptr)
     {
-        arrNode->setItem(std::get<int32_t>(index.value), value);
+        arrNode->setItem(index.value.integer, value);
     }
-    else if (StringNode *strNode = dynamic_cast<StringNode *>(m); strNode != nullptr && value.type == Type::Char)
+    else if (StringNode *strNode = m->as<StringNode>(); strNode != nullptr && value.type == Type::Char)
     {
-        strNode->setCharAt(std::get<char>(value.value), std::get<int32_t>(index.value));
+        // changed string no longer matches the hash it was interned with
+        _removeInternedString(strNode);
+        strNode->setCharAt(value.value.character, index.value.integer);
     }
 }
 
@@ -874,28 +1659,14 @@ void GobLang::Machine::_eq()
 {
     MemoryValue b = _getFromTopAndPop();
     MemoryValue a = _getFromTopAndPop();
-    if (a.type == b.type || a.type == Type::Null || b.type == Type::Null)
-    {
-        pushToStack(MemoryValue{.type = Type::Bool, .value = areEqual(a, b)});
-    }
-    else
-    {
-        throw RuntimeException(std::string("Attempted to compare value of ") + typeToString(a.type) + " and " + typeToString(b.type));
-    }
+    pushToStack(MemoryValue{.type = Type::Bool, .value = _compare(Operation::Equals, a, b)});
 }
 
 void GobLang::Machine::_neq()
 {
     MemoryValue b = _getFromTopAndPop();
     MemoryValue a = _getFromTopAndPop();
-    if (a.type != b.type && !(a.type == Type::Null || b.type == Type::Null))
-    {
-        throw RuntimeException(std::string("Attempted to compare value of ") + typeToString(a.type) + " and " + typeToString(b.type));
-    }
-    else
-    {
-        pushToStack(MemoryValue{.type = Type::Bool, .value = !areEqual(a, b)});
-    }
+    pushToStack(MemoryValue{.type = Type::Bool, .value = _compare(Operation::NotEq, a, b)});
 }
 
 void GobLang::Machine::_and()
@@ -908,7 +1679,7 @@ void GobLang::Machine::_and()
     }
     else
     {
-        pushToStack(MemoryValue{.type = Type::Bool, .value = std::get<bool>(a.value) && std::get<bool>(b.value)});
+        pushToStack(MemoryValue{.type = Type::Bool, .value = a.value.boolean && b.value.boolean});
     }
 }
 
@@ -922,7 +1693,7 @@ void GobLang::Machine::_or()
     }
     else
     {
-        pushToStack(MemoryValue{.type = Type::Bool, .value = std::get<bool>(a.value) || std::get<bool>(b.value)});
+        pushToStack(MemoryValue{.type = Type::Bool, .value = a.value.boolean || b.value.boolean});
     }
 }
 
@@ -930,96 +1701,80 @@ void GobLang::Machine::_less()
 {
     MemoryValue b = _getFromTopAndPop();
     MemoryValue a = _getFromTopAndPop();
-    if (a.type != b.type)
-    {
-        throw RuntimeException(std::string("Attempted to compare value of ") + typeToString(a.type) + " and " + typeToString(b.type));
-    }
-    else
-    {
-        switch (a.type)
-        {
-        case Type::Int:
-            pushToStack(MemoryValue{.type = Type::Bool, .value = std::get<int32_t>(a.value) < std::get<int32_t>(b.value)});
-            break;
-        case Type::Float:
-            pushToStack(MemoryValue{.type = Type::Bool, .value = std::get<float>(a.value) < std::get<float>(b.value)});
-            break;
-        default:
-            throw RuntimeException(std::string("Attempted to compare value of type ") + typeToString(a.type) + ". Only numeric types can be compared using >,<, <=, >=");
-        }
-    }
+    pushToStack(MemoryValue{.type = Type::Bool, .value = _compare(Operation::Less, a, b)});
 }
 
 void GobLang::Machine::_more()
 {
     MemoryValue b = _getFromTopAndPop();
     MemoryValue a = _getFromTopAndPop();
-    if (a.type != b.type)
-    {
-        throw RuntimeException(std::string("Attempted to compare value of ") + typeToString(a.type) + " and " + typeToString(b.type));
-    }
-    else
-    {
-        switch (a.type)
-        {
-        case Type::Int:
-            pushToStack(MemoryValue{.type = Type::Bool, .value = std::get<int32_t>(a.value) > std::get<int32_t>(b.value)});
-            break;
-        case Type::Float:
-            pushToStack(MemoryValue{.type = Type::Bool, .value = std::get<float>(a.value) > std::get<float>(b.value)});
-            break;
-        default:
-            throw RuntimeException(std::string("Attempted to compare value of type ") + typeToString(a.type) + ". Only numeric types can be compared using >,<, <=, >=");
-        }
-    }
+    pushToStack(MemoryValue{.type = Type::Bool, .value = _compare(Operation::More, a, b)});
 }
 
 void GobLang::Machine::_lessOrEq()
 {
     MemoryValue b = _getFromTopAndPop();
     MemoryValue a = _getFromTopAndPop();
-    if (a.type != b.type)
-    {
-        throw RuntimeException(std::string("Attempted to compare value of ") + typeToString(a.type) + " and " + typeToString(b.type));
-    }
-    else
-    {
-        switch (a.type)
-        {
-        case Type::Int:
-            pushToStack(MemoryValue{.type = Type::Bool, .value = std::get<int32_t>(a.value) <= std::get<int32_t>(b.value)});
-            break;
-        case Type::Float:
-            pushToStack(MemoryValue{.type = Type::Bool, .value = std::get<float>(a.value) <= std::get<float>(b.value)});
-            break;
-        default:
-            throw RuntimeException(std::string("Attempted to compare value of type ") + typeToString(a.type) + ". Only numeric types can be compared using >,<, <=, >=");
-        }
-    }
+    pushToStack(MemoryValue{.type = Type::Bool, .value = _compare(Operation::LessOrEq, a, b)});
 }
 
 void GobLang::Machine::_moreOrEq()
 {
     MemoryValue b = _getFromTopAndPop();
     MemoryValue a = _getFromTopAndPop();
+    pushToStack(MemoryValue{.type = Type::Bool, .value = _compare(Operation::MoreOrEq, a, b)});
+}
+
+bool GobLang::Machine::_compare(Operation op, MemoryValue const &a, MemoryValue const &b)
+{
+    if (op == Operation::Equals || op == Operation::NotEq)
+    {
+        if (a.type != b.type && a.type != Type::Null && b.type != Type::Null)
+        {
+            throw RuntimeException(std::string("Attempted to compare value of ") + typeToString(a.type) + " and " + typeToString(b.type));
+        }
+        return areEqual(a, b) == (op == Operation::Equals);
+    }
     if (a.type != b.type)
     {
         throw RuntimeException(std::string("Attempted to compare value of ") + typeToString(a.type) + " and " + typeToString(b.type));
     }
-    else
+    switch (a.type)
     {
-        switch (a.type)
+    case Type::Int:
+        switch (op)
         {
-        case Type::Int:
-            pushToStack(MemoryValue{.type = Type::Bool, .value = std::get<int32_t>(a.value) >= std::get<int32_t>(b.value)});
-            break;
-        case Type::Float:
-            pushToStack(MemoryValue{.type = Type::Bool, .value = std::get<float>(a.value) >= std::get<float>(b.value)});
+        case Operation::Less:
+            return a.value.integer < b.value.integer;
+        case Operation::More:
+            return a.value.integer > b.value.integer;
+        case Operation::LessOrEq:
+            return a.value.integer <= b.value.integer;
+        case Operation::MoreOrEq:
+            return a.value.integer >= b.value.integer;
+        default:
             break;
+        }
+        break;
+    case Type::Float:
+        switch (op)
+        {
+        case Operation::Less:
+            return a.value.floating < b.value.floating;
+        case Operation::More:
+            return a.value.floating > b.value.floating;
+        case Operation::LessOrEq:
+            return a.value.floating <= b.value.floating;
+        case Operation::MoreOrEq:
+            return a.value.floating >= b.value.floating;
         default:
-            throw RuntimeException(std::string("Attempted to compare value of type ") + typeToString(a.type) + ". Only numeric types can be compared using >,<, <=, >=");
+            break;
         }
+        break;
+    default:
+        throw RuntimeException(std::string("Attempted to compare value of type ") + typeToString(a.type) + ". Only numeric types can be compared using >,<, <=, >=");
     }
+    throw RuntimeException(std::string("Invalid comparison operation code: ") + std::to_string((int32_t)op));
 }
 
 void GobLang::Machine::_negate()
@@ -1028,10 +1783,10 @@ void GobLang::Machine::_negate()
     switch (val.type)
     {
     case Type::Int:
-        pushToStack(MemoryValue{.type = Type::Int, .value = -std::get<int32_t>(val.value)});
+        pushToStack(MemoryValue{.type = Type::Int, .value = -val.value.integer});
         break;
     case Type::Float:
-        pushToStack(MemoryValue{.type = Type::Float, .value = -std::get<float>(val.value)});
+        pushToStack(MemoryValue{.type = Type::Float, .value = -val.value.floating});
         break;
     default:
         throw RuntimeException("Attempted to apply negate operation on a non numeric value");
@@ -1045,7 +1800,7 @@ void GobLang::Machine::_not()
     {
         throw RuntimeException("Attempted to negate non boolean value");
     }
-    pushToStack(MemoryValue{.type = Type::Bool, .value = !std::get<bool>(val.value)});
+    pushToStack(MemoryValue{.type = Type::Bool, .value = !val.value.boolean});
 }
 
 void GobLang::Machine::_shrink()
@@ -1055,6 +1810,48 @@ void GobLang::Machine::_shrink()
     shrinkLocalVariableStackBy(amount);
 }
 
+void GobLang::Machine::_incrementLocal()
+{
+    MemoryValue *val = _getExistingLocal(m_operations[m_programCounter + 1]);
+    int32_t delta = _parseOperationConstant<int32_t>(m_programCounter + 2);
+    m_programCounter += 1 + sizeof(int32_t);
+    if (val->type != Type::Int)
+    {
+        throw RuntimeException(std::string("Attempted to add values of ") + typeToString(val->type) + " and " + typeToString(Type::Int));
+    }
+    val->value.integer += delta;
+}
+
+void GobLang::Machine::_jumpIfNotCompareLocals()
+{
+    MemoryValue const *a = _getExistingLocal(m_operations[m_programCounter + 1]);
+    MemoryValue const *b = _getExistingLocal(m_operations[m_programCounter + 2]);
+    Operation op = (Operation)m_operations[m_programCounter + 3];
+    if (_compare(op, *a, *b))
+    {
+        m_programCounter += 4 + sizeof(ProgramAddressType);
+    }
+    else
+    {
+        m_programCounter = _getAddressFromByteCode(m_programCounter + 4);
+    }
+}
+
+void GobLang::Machine::_jumpIfNotCompareLocalConst()
+{
+    MemoryValue const *a = _getExistingLocal(m_operations[m_programCounter + 1]);
+    MemoryValue b = MemoryValue{.type = Type::Int, .value = _parseOperationConstant<int32_t>(m_programCounter + 2)};
+    Operation op = (Operation)m_operations[m_programCounter + 2 + sizeof(int32_t)];
+    if (_compare(op, *a, b))
+    {
+        m_programCounter += 3 + sizeof(int32_t) + sizeof(ProgramAddressType);
+    }
+    else
+    {
+        m_programCounter = _getAddressFromByteCode(m_programCounter + 3 + sizeof(int32_t));
+    }
+}
+
 void GobLang::Machine::_createArray()
 {
     m_programCounter++;
@@ -1066,3 +1863,181 @@ void GobLang::Machine::_createArray()
     }
     pushToStack(MemoryValue{.type = Type::MemoryObj, .value = array});
 }
+
+void GobLang::Machine::_performArithmeticOperation(Operation op)
+{
+    switch (op)
+    {
+    case Operation::Add:
+        _add();
+        break;
+    case Operation::Sub:
+        _sub();
+        break;
+    case Operation::Mul:
+        _mul();
+        break;
+    case Operation::Div:
+        _div();
+        break;
+    case Operation::Modulo:
+        _mod();
+        break;
+    case Operation::BitAnd:
+        _bitAnd();
+        break;
+    case Operation::BitOr:
+        _bitOr();
+        break;
+    case Operation::BitXor:
+        _bitXor();
+        break;
+    case Operation::ShiftLeft:
+        _shiftLeft();
+        break;
+    case Operation::ShiftRight:
+        _shiftRight();
+        break;
+    default:
+        throw RuntimeException(std::string("Invalid operation used for combined assignment: ") + std::to_string((int32_t)op));
+    }
+}
+
+void GobLang::Machine::_operateLocal()
+{
+    uint8_t id = m_operations[m_programCounter + 1];
+    Operation op = (Operation)m_operations[m_programCounter + 2];
+    m_programCounter += 2;
+    MemoryValue value = _getFromTopAndPop();
+    pushToStack(*_getExistingLocal(id));
+    pushToStack(value);
+    _performArithmeticOperation(op);
+    setLocalVariableValue(id, _getFromTopAndPop());
+}
+
+void GobLang::Machine::_operateGlobal()
+{
+    size_t slot = m_operations[m_programCounter + 1];
+    Operation op = (Operation)m_operations[m_programCounter + 2];
+    m_programCounter += 2;
+    if (slot >= m_globals.size() || !m_globalDefined[slot])
+    {
+        throw RuntimeException(std::string("Attempted to get variable '") + (slot < m_globalNames.size() ? m_globalNames[slot] : std::to_string(slot)) + "', which doesn't exist");
+    }
+    MemoryValue value = _getFromTopAndPop();
+    pushToStack(m_globals[slot]);
+    pushToStack(value);
+    _performArithmeticOperation(op);
+    _setGlobalValue(slot, _getFromTopAndPop());
+}
+
+void GobLang::Machine::_operateArray()
+{
+    m_programCounter++;
+    Operation op = (Operation)m_operations[m_programCounter];
+    MemoryValue value = _getFromTopAndPop();
+    MemoryValue array = _getFromTopAndPop();
+    MemoryValue index = _getFromTopAndPop();
+    _pushArrayItem(array, index);
+    pushToStack(value);
+    _performArithmeticOperation(op);
+    _setArrayItem(array, index, _getFromTopAndPop());
+}
+
+void GobLang::Machine::_quicken(Operation intOp, Operation floatOp)
+{
+    if (m_stack.size() < 2)
+    {
+        return;
+    }
+    Type a = m_stack[m_stack.size() - 2].type;
+    Type b = m_stack.back().type;
+    if (a == Type::Int && b == Type::Int)
+    {
+        m_operations[m_programCounter] = (uint8_t)intOp;
+    }
+    else if (a == Type::Float && b == Type::Float)
+    {
+        m_operations[m_programCounter] = (uint8_t)floatOp;
+    }
+}
+
+void GobLang::Machine::_arithmeticQuickened(Operation op, Type type)
+{
+    if (m_stack.size() < 2 || m_stack.back().type != type || m_stack[m_stack.size() - 2].type != type)
+    {
+        // types no longer match the specialization, so the generic version which can handle any type is used from now on
+        m_operations[m_programCounter] = (uint8_t)op;
+        _performArithmeticOperation(op);
+        return;
+    }
+    MemoryValue &a = m_stack[m_stack.size() - 2];
+    MemoryValue const &b = m_stack.back();
+    if (type == Type::Int)
+    {
+        switch (op)
+        {
+        case Operation::Add:
+            a.value.integer = a.value.integer + b.value.integer;
+            break;
+        case Operation::Sub:
+            a.value.integer = a.value.integer - b.value.integer;
+            break;
+        case Operation::Mul:
+            a.value.integer = a.value.integer * b.value.integer;
+            break;
+        default:
+            _checkDivision(a, b);
+            a.value.integer = a.value.integer / b.value.integer;
+            break;
+        }
+    }
+    else
+    {
+        switch (op)
+        {
+        case Operation::Add:
+            a.value.floating = a.value.floating + b.value.floating;
+            break;
+        case Operation::Sub:
+            a.value.floating = a.value.floating - b.value.floating;
+            break;
+        case Operation::Mul:
+            a.value.floating = a.value.floating * b.value.floating;
+            break;
+        default:
+            a.value.floating = a.value.floating / b.value.floating;
+            break;
+        }
+    }
+    m_stack.pop_back();
+}
+
+void GobLang::Machine::_compareQuickened(Operation op, Type type, bool fuseJump)
+{
+    if (m_stack.size() < 2 || m_stack.back().type != type || m_stack[m_stack.size() - 2].type != type)
+    {
+        m_operations[m_programCounter] = (uint8_t)op;
+        MemoryValue b = _getFromTopAndPop();
+        MemoryValue a = _getFromTopAndPop();
+        pushToStack(MemoryValue{.type = Type::Bool, .value = _compare(op, a, b)});
+        m_programCounter++;
+        return;
+    }
+    MemoryValue const &a = m_stack[m_stack.size() - 2];
+    MemoryValue const &b = m_stack.back();
+    bool result = type == Type::Int ? _compareNumbers(op, a.value.integer, b.value.integer)
+                                    : _compareNumbers(op, a.value.floating, b.value.floating);
+    m_stack.pop_back();
+    m_stack.pop_back();
+    size_t next = m_programCounter + 1;
+    // jump can only be merged if nothing expects to stop on it
+    if (fuseJump && next < m_operations.size() && m_operations[next] == (uint8_t)Operation::JumpIfNot &&
+        (m_breakpoints.empty() || m_breakpoints.count(next) == 0))
+    {
+        m_programCounter = result ? next + 1 + sizeof(ProgramAddressType) : _getAddressFromByteCode(next + 1);
+        return;
+    }
+    pushToStack(MemoryValue{.type = Type::Bool, .value = result});
+    m_programCounter = next;
+}
@@ -1,5 +1,8 @@
 #pragma once
 #include <map>
+#include <deque>
+#include <unordered_map>
+#include <set>
 #include <vector>
 #include <cstdint>
 #include <string>
@@ -8,6 +11,7 @@
 
 #include "Type.hpp"
 #include "Memory.hpp"
+#include "Heap.hpp"
 #include "Operations.hpp"
 #include "Value.hpp"
 #include "Array.hpp"
@@ -21,6 +25,50 @@ namespace GobLang
      *
      */
     using ProgramAddressType = size_t;
+
+    /**
+     * @brief Record of a single function call. All values of the frame are stored in the shared value stack of the machine
+     * with local variables occupying range [localsBase, operandBase) and operation stack starting at operandBase
+     *
+     */
+    struct CallFrame
+    {
+        /**
+         * @brief Where the jump into the function happened from
+         *
+         */
+        size_t returnAddress;
+        /**
+         * @brief Index of the first local variable of this frame in the value stack
+         *
+         */
+        size_t localsBase;
+        /**
+         * @brief Index of the first operation stack value of this frame in the value stack
+         *
+         */
+        size_t operandBase;
+    };
+
+    /**
+     * @brief Settings that control how often garbage collection happens.
+     * Collection only starts once enough objects were allocated since the last collection
+     *
+     */
+    struct GcPolicy
+    {
+        /**
+         * @brief Minimal amount of allocations between two collections
+         *
+         */
+        size_t minThreshold = 1024;
+        /**
+         * @brief How much the heap is allowed to grow relative to the amount of objects that survived the last collection before collecting again
+         *
+         */
+        float growthFactor = 2.f;
+    };
+
     class Machine
     {
     public:
@@ -54,9 +102,38 @@ namespace GobLang
         {
             return m_programCounter >= m_operations.size() || m_forcedEnd;
         }
+        /**
+         * @brief Register a native function and make it accessible as a global variable.
+         * If a function with this name was already registered or is called by the byte code directly, it will be replaced
+         *
+         * @param func Function to call
+         * @param name Name of the function
+         */
         void addFunction(FunctionValue const &func, std::string const &name);
+
+        /**
+         * @brief Execute a single operation at the current program counter
+         *
+         */
         void step();
 
+        /**
+         * @brief Execute operations until the program ends or a breakpoint is reached.
+         * Operation at the current program counter is always executed, so calling this again after stopping at breakpoint will resume execution.
+         * Errors are reported by throwing `RuntimeException` leaving program counter at the failed operation
+         *
+         */
+        void run();
+
+        /**
+         * @brief Add a breakpoint that will stop `run()` before executing operation at the given address
+         *
+         * @param address Address of the operation in the byte code
+         */
+        void addBreakpoint(size_t address);
+
+        void removeBreakpoint(size_t address);
+
         void printGlobalsInfo();
 
         void printVariablesInfo();
@@ -73,14 +150,15 @@ namespace GobLang
          * @brief Create a new string object in memory
          *
          * @param str Base string to store in memory
-         * @param alwaysNew If true that means that it will skip search and always create new memory object.
+         * @param alwaysNew If true that means that it will skip search in the interning table and always create new memory object which will not be interned.
          * This is useful to avoid messing variables that were set from constants
          * @return StringNode* Pointer to new string object or other string object that was found in memory
          */
         StringNode *createString(std::string const &str, bool alwaysNew = false);
 
         /**
-         * @brief Register object to be handled by the garbage collector. This object will be ref counted and deleted once it is no longer in use
+         * @brief Register object to be handled by the garbage collector. This object will be deleted once it can no longer be reached from the machine.
+         * Object must be allocated using `new`
          *
          * @param obj Object to register
          */
@@ -90,7 +168,13 @@ namespace GobLang
 
         void pushToStack(MemoryValue const &val);
 
-        MemoryValue getVariableValue(std::string const &name) { return m_globals[name]; }
+        /**
+         * @brief Get value of a global variable
+         *
+         * @param name Name of the variable
+         * @return MemoryValue Value of the variable or null if variable was never set
+         */
+        MemoryValue getVariableValue(std::string const &name);
 
         /**
          * @brief Set local variable value using id. If id is larger than current amount of variables the array will be expanded to match the id
@@ -120,12 +204,37 @@ namespace GobLang
          */
         void createVariable(std::string const &name, MemoryValue const &value);
 
-        void collectGarbage();
+        /**
+         * @brief Delete all objects that are no longer in use, ignoring current garbage collection policy
+         *
+         */
+        void collect();
+
+        /**
+         * @brief Set policy used to decide when garbage collection should run. Takes effect after the next collection
+         *
+         * @param policy New policy
+         */
+        void setGcPolicy(GcPolicy const &policy);
+
+        GcPolicy const &getGcPolicy() const { return m_gcPolicy; }
+
+        /**
+         * @brief Get amount of objects currently stored in the heap, including ones that are no longer used but weren't collected yet
+         *
+         */
+        size_t getObjectCount() const { return m_heap.getObjectCount(); }
+
+        /**
+         * @brief Get amount of function calls that haven't returned yet, including the main code
+         *
+         */
+        size_t getCallDepth() const { return m_callStack.size(); }
 
         ~Machine();
 
     private:
-        inline MemoryValue _operationTop() { return m_operationStack.back().back(); }
+        inline MemoryValue _operationTop() { return m_stack.back(); }
 
         inline MemoryValue _getFromTopAndPop()
         {
@@ -135,6 +244,159 @@ namespace GobLang
         }
         ProgramAddressType _getAddressFromByteCode(size_t start);
 
+        /**
+         * @brief Run garbage collection if enough objects were allocated since the last collection. Should only be called at points where all used objects are referenced
+         *
+         */
+        inline void _collectGarbageIfNeeded()
+        {
+            if (m_heap.getAllocationCount() >= m_nextCollectionAllocation)
+            {
+                collect();
+            }
+        }
+
+        /**
+         * @brief Get slot used by the global variable with the given name. If no variable uses this name a new undefined slot is created
+         *
+         * @param name Name of the global variable
+         * @return size_t Index of the slot in the global variable array
+         */
+        size_t _getGlobalSlot(std::string const &name);
+
+        /**
+         * @brief Write value into the global variable slot and mark the variable as defined
+         *
+         * @param slot Slot of the variable
+         * @param val New value
+         */
+        void _setGlobalValue(size_t slot, MemoryValue const &val);
+
+        /**
+         * @brief Get id of the native function with the given name. If no function uses this name a new unbound entry is created
+         *
+         * @param name Name of the native function
+         * @return size_t Index of the function in the native function table
+         */
+        size_t _getNativeFunctionId(std::string const &name);
+
+        /**
+         * @brief Call native function using its id, throwing if nothing was bound to this id
+         *
+         * @param id Index of the function in the native function table
+         */
+        void _invokeNativeFunction(size_t id);
+
+        /**
+         * @brief Remove string from the interning table. Must be done before the string is changed or deleted
+         *
+         * @param str String to remove
+         */
+        void _removeInternedString(StringNode *str);
+
+        /**
+         * @brief Get local variable with the given id, throwing if no variable uses it
+         *
+         * @param id Id of the local variable
+         * @return MemoryValue* Value of the local variable
+         */
+        MemoryValue *_getExistingLocal(size_t id);
+
+        /**
+         * @brief Compare two values using one of the comparison operations
+         *
+         * @param op Comparison operation: Equals, NotEq, Less, More, LessOrEq or MoreOrEq
+         * @param a Left side of the comparison
+         * @param b Right side of the comparison
+         * @return Result of the comparison
+         */
+        bool _compare(Operation op, MemoryValue const &a, MemoryValue const &b);
+
+        /**
+         * @brief Push item of array or character of string at the given index to the stack
+         *
+         * @param array Array or string value
+         * @param index Index of the item
+         */
+        void _pushArrayItem(MemoryValue const &array, MemoryValue const &index);
+
+        /**
+         * @brief Push item of array at the given index to the stack without checking the index. Strings are handled the same way as in `_pushArrayItem`
+         *
+         * @param array Array or string value
+         * @param index Int index that is known to be inside of the array
+         */
+        void _pushArrayItemUnchecked(MemoryValue const &array, MemoryValue const &index);
+
+        /**
+         * @brief Set item of array or character of string at the given index
+         *
+         * @param array Array or string value
+         * @param index Index of the item
+         * @param value New value of the item
+         */
+        void _setArrayItem(MemoryValue const &array, MemoryValue const &index, MemoryValue const &value);
+
+        /**
+         * @brief Perform arithmetic operation on two values at the top of the stack, replacing them with the result
+         *
+         * @param op Operation to perform, must be one of the operations accepted by `isArithmeticOperation`
+         */
+        void _performArithmeticOperation(Operation op);
+
+        /**
+         * @brief Make sure that integer division or modulo of the values can be calculated, since invalid ones would crash the process instead of failing
+         *
+         * @param dividend Left side of the operation
+         * @param divisor Right side of the operation
+         * @throws RuntimeException Divisor is zero or result doesn't fit into an int
+         */
+        void _checkDivision(MemoryValue const &dividend, MemoryValue const &divisor) const;
+
+        /**
+         * @brief Replace operation at the program counter with its specialized version if both values at the top of the stack are ints or floats
+         *
+         * @param intOp Operation to use for int values
+         * @param floatOp Operation to use for float values
+         */
+        inline void _quicken(Operation intOp, Operation floatOp);
+
+        /**
+         * @brief Perform arithmetic operation specialized for the given type.
+         * If values have different type operation is replaced back with its generic version
+         *
+         * @param op Generic version of the operation
+         * @param type Type of values the operation was specialized for
+         */
+        inline void _arithmeticQuickened(Operation op, Type type);
+
+        /**
+         * @brief Perform comparison specialized for the given type.
+         * If values have different type operation is replaced back with its generic version.
+         * Advances program counter by itself
+         *
+         * @param op Generic version of the operation
+         * @param type Type of values the operation was specialized for
+         * @param fuseJump If true and next operation is `goto_if_not`, it is performed as well without pushing the result to the stack
+         */
+        inline void _compareQuickened(Operation op, Type type, bool fuseJump);
+
+        template <typename T>
+        static bool _compareNumbers(Operation op, T a, T b)
+        {
+            switch (op)
+            {
+            case Operation::Less:
+                return a < b;
+            case Operation::More:
+                return a > b;
+            case Operation::LessOrEq:
+                return a <= b;
+            default:
+                return a >= b;
+            }
+        }
+
         /// @brief Parse next `sizeof(T)` bytes into a T value using bitshifts and reinterpret cast
         /// @tparam T Type of the value to convert into
         /// @param start Where in the byte code to start from
@@ -156,6 +418,21 @@ namespace GobLang
 
         inline void _jumpIf();
 
+        inline void _jumpIfTrue();
+
+        /**
+         * @brief Jump forward keeping the condition on the stack if it matches the given value, otherwise pop the condition
+         *
+         * @param jumpValue Value of the condition at which jump happens
+         */
+        inline void _jumpIfOrPop(bool jumpValue);
+
+        /**
+         * @brief Make sure that value at the top of the stack is a bool, which is used for the right side of `&&` and `||`
+         *
+         */
+        inline void _checkBool();
+
         inline void _add();
 
         inline void _sub();
@@ -170,6 +447,10 @@ namespace GobLang
 
         inline void _get();
 
+        inline void _setGlobal();
+
+        inline void _getGlobal();
+
         inline void _bitAnd();
 
         inline void _bitOr();
@@ -186,10 +467,16 @@ namespace GobLang
 
         inline void _getLocal();
 
+        inline void _setLocalKeep();
+
         inline void _call();
 
         inline void _callLocal();
 
+        inline void _tailCallLocal();
+
+        inline void _callNative();
+
         inline void _return();
 
         inline void _returnWithValue();
@@ -234,31 +521,95 @@ namespace GobLang
 
         inline void _createArray();
 
+        inline void _incrementLocal();
+
+        inline void _jumpIfNotCompareLocals();
+
+        inline void _jumpIfNotCompareLocalConst();
+
+        inline void _getArrayLocal();
+
+        inline void _getArrayUnchecked();
+
+        inline void _getArrayLocalUnchecked();
+
+        inline void _setArrayUnchecked();
+
+        inline void _operateLocal();
+
+        inline void _operateGlobal();
+
+        inline void _operateArray();
+
         bool m_forcedEnd = false;
 
-        MemoryNode m_memoryRoot;
+        /**
+         * @brief Addresses at which `run()` should stop
+         *
+         */
+        std::set<size_t> m_breakpoints;
+
+        /**
+         * @brief Storage of all objects created by the machine
+         *
+         */
+        Heap m_heap;
+        GcPolicy m_gcPolicy;
+        /**
+         * @brief Value of the heap allocation counter at which next collection will happen
+         *
+         */
+        size_t m_nextCollectionAllocation = GcPolicy().minThreshold;
+        /**
+         * @brief Strings that can be reused by `createString`. Key is the hash of the string
+         *
+         */
+        std::unordered_multimap<size_t, StringNode *> m_internedStrings;
         size_t m_programCounter = 0;
         std::vector<uint8_t> m_operations;
-        std::vector<std::vector<MemoryValue>> m_operationStack = {{}};
         /**
-         * @brief Special dictionary that can be written externally and internally which uses strings to identify variables.
+         * @brief Values of all call frames. Each frame stores local variables followed by its operation stack
          *
-         * Any variable that doesn't have a valid local variable attached will attempt to read a global variable value
          */
-        std::map<std::string, MemoryValue> m_globals;
+        std::vector<MemoryValue> m_stack;
         /**
-         * @brief Array of currently present local variables.
-         *  These variables can only be addressed by their index and will be overriden once the id is used in a different block
+         * @brief Values of global variables that can be written externally and internally.
          *
+         * Any variable that doesn't have a valid local variable attached will attempt to read a global variable value.
+         * Code accesses globals by slot index, names are only resolved once using `m_globalSlots`
          */
-        std::vector<std::vector<MemoryValue>> m_variables = {{}};
+        std::vector<MemoryValue> m_globals;
+        /**
+         * @brief Whether the global variable in the same slot was ever assigned
+         *
+         */
+        std::vector<bool> m_globalDefined;
+        /**
+         * @brief Names of global variables in the same order as their slots
+         *
+         */
+        std::vector<std::string> m_globalNames;
+        std::map<std::string, size_t> m_globalSlots;
         std::vector<std::string> m_constStrings;
         std::vector<Function> m_functions;
+        /**
+         * @brief Native functions registered in the machine. Values of native function type store index into this table.
+         * Deque is used so that registering a function from inside of a native call doesn't move the function being executed
+         *
+         */
+        std::deque<FunctionValue> m_nativeFunctions;
+        /**
+         * @brief Names of native functions in the same order as the function table
+         *
+         */
+        std::vector<std::string> m_nativeFunctionNames;
+        std::map<std::string, size_t> m_nativeFunctionIds;
 
         /**
-         * @brief Return locations for all of the call operations. This points to where the jump happened from
+         * @brief All currently active function calls. First frame belongs to the main code and is never removed.
+         * Local variables can only be addressed by their index in the frame and will be overriden once the id is used in a different block
          *
          */
-        std::vector<size_t> m_callStack;
+        std::vector<CallFrame> m_callStack = {CallFrame{.returnAddress = 0, .localsBase = 0, .operandBase = 0}};
     };
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Memory.hpp"
+#include <atomic>
 void GobLang::MemoryNode::insert(MemoryNode *node)
 {
     if (node != nullptr)
@@ -32,6 +33,41 @@ void GobLang::MemoryNode::pushBack(MemoryNode *node)
     curr->m_next = node;
 }
 
+GobLang::MemoryNodeKind GobLang::registerMemoryNodeKind()
+{
+    static std::atomic<MemoryNodeKind> nextKind = MemoryNodeKinds::FirstCustom;
+    return nextKind++;
+}
+
+void GobLang::MemoryTracer::mark(MemoryNode *node)
+{
+    if (node == nullptr || node->isMarked())
+    {
+        return;
+    }
+    node->setMarked(true);
+    m_pending.push_back(node);
+}
+
+void GobLang::MemoryTracer::mark(MemoryValue const &value)
+{
+    if (value.type == Type::MemoryObj)
+    {
+        mark(value.value.object);
+    }
+}
+
+void GobLang::MemoryTracer::traceAll()
+{
+    // explicit list is used instead of recursion to avoid running out of stack on deeply nested objects
+    while (!m_pending.empty())
+    {
+        MemoryNode *node = m_pending.back();
+        m_pending.pop_back();
+        node->trace(*this);
+    }
+}
+
 void GobLang::MemoryNode::increaseRefCount()
 {
     m_refCount++;
@@ -75,12 +111,32 @@ char GobLang::StringNode::getCharAt(size_t ind)
 void GobLang::StringNode::setCharAt(char ch, size_t ind)
 {
     m_str[ind] = ch;
+    m_hashValid = false;
+}
+
+size_t GobLang::StringNode::getHash()
+{
+    if (!m_hashValid)
+    {
+        m_hash = std::hash<std::string>{}(m_str);
+        m_hashValid = true;
+    }
+    return m_hash;
 }
 
 bool GobLang::StringNode::equalsTo(MemoryNode *other)
 {
-    if (StringNode *otherStr = dynamic_cast<StringNode *>(other); otherStr != nullptr)
+    if (other == this)
+    {
+        return true;
+    }
+    if (StringNode *otherStr = other->as<StringNode>(); otherStr != nullptr)
     {
+        // strings of different length or hash can never be equal, so full comparison can be skipped
+        if (otherStr->getSize() != getSize() || otherStr->getHash() != getHash())
+        {
+            return false;
+        }
         return otherStr->getString() == getString();
     }
     return false;
@@ -3,9 +3,77 @@
 #include <vector>
 #include <iostream>
 #include <cstdint>
+#include <functional>
 #include "Type.hpp"
+#include "Value.hpp"
 namespace GobLang
 {
+    class MemoryNode;
+
+    /**
+     * @brief Id of the concrete type of a memory node. Used to check type of the object without relying on RTTI
+     *
+     */
+    using MemoryNodeKind = uint16_t;
+
+    /**
+     * @brief Kinds of memory nodes provided by the interpreter. Custom node types should get their kind using `registerMemoryNodeKind`
+     *
+     */
+    namespace MemoryNodeKinds
+    {
+        constexpr MemoryNodeKind Generic = 0;
+        constexpr MemoryNodeKind String = 1;
+        constexpr MemoryNodeKind Array = 2;
+        /**
+         * @brief First kind that is given out by `registerMemoryNodeKind`
+         *
+         */
+        constexpr MemoryNodeKind FirstCustom = 3;
+    }
+
+    /**
+     * @brief Create a new unique kind for a custom memory node type. Type should call it once and store the result
+     *
+     * @return MemoryNodeKind New unused kind
+     */
+    MemoryNodeKind registerMemoryNodeKind();
+
+    /**
+     * @brief Helper used by the garbage collector to find all objects that can still be reached
+     *
+     */
+    class MemoryTracer
+    {
+    public:
+        /**
+         * @brief Mark object as reachable. Objects referenced by it will be marked during `traceAll`
+         *
+         * @param node Object to mark. Can be nullptr
+         */
+        void mark(MemoryNode *node);
+
+        /**
+         * @brief Mark object stored in the value if value stores an object
+         *
+         * @param value Value to mark
+         */
+        void mark(MemoryValue const &value);
+
+        /**
+         * @brief Mark every object reachable from already marked objects
+         *
+         */
+        void traceAll();
+
+    private:
+        /**
+         * @brief Objects that were marked, but whose references were not traced yet
+         *
+         */
+        std::vector<MemoryNode *> m_pending;
+    };
+
     /**
      * @brief Class used to represent interpreter memory by using a linked list
      *
@@ -13,13 +81,38 @@ namespace GobLang
     class MemoryNode
     {
     public:
+        explicit MemoryNode(MemoryNodeKind kind = MemoryNodeKinds::Generic) : m_kind(kind) {}
+
+        MemoryNodeKind getKind() const { return m_kind; }
+
         /**
-         * @brief Should be deleted by the garbage collector or not
+         * @brief Check if this node is exactly of given type. Type must provide static `nodeKind()` function
+         *
+         * @tparam T Type to check
+         */
+        template <typename T>
+        bool is() const { return m_kind == T::nodeKind(); }
+
+        /**
+         * @brief Cast this node to the given type if the kind of this node matches that type
+         *
+         * @tparam T Type to cast to. Type must provide static `nodeKind()` function
+         * @return T* This node as T or nullptr if node has different kind
+         */
+        template <typename T>
+        T *as() { return is<T>() ? static_cast<T *>(this) : nullptr; }
+
+        /**
+         * @brief Should be deleted by the garbage collector or not. Only valid during garbage collection once all reachable objects were marked
          *
          * @return true
          * @return false
          */
-        bool isDead() const { return m_dead || m_refCount <= 0; }
+        bool isDead() const { return m_dead || !m_marked; }
+
+        bool isMarked() const { return m_marked; }
+
+        void setMarked(bool marked) { m_marked = marked; }
         /**
          * @brief Get the next node in the list
          *
@@ -46,8 +139,17 @@ namespace GobLang
          */
         void pushBack(MemoryNode *node);
 
+        /**
+         * @brief Pin the object, preventing it from being collected while it's not reachable from the machine.
+         * Useful for objects held by native code, as the machine only sees values on the stack and in variables
+         *
+         */
         void increaseRefCount();
 
+        /**
+         * @brief Remove one pin added by `increaseRefCount`
+         *
+         */
         void decreaseRefCount();
 
         int32_t getRefCount() const { return m_refCount; }
@@ -76,6 +178,13 @@ namespace GobLang
          */
         virtual std::string toString(bool pretty = false) { return "Memory object"; }
 
+        /**
+         * @brief Mark all objects referenced by this object. Custom types that store other objects must override this, otherwise referenced objects will be collected
+         *
+         * @param tracer Tracer to mark objects with
+         */
+        virtual void trace(MemoryTracer &/*tracer*/) {}
+
         virtual ~MemoryNode() = default;
 
     private:
@@ -90,16 +199,47 @@ namespace GobLang
          */
         bool m_dead = false;
 
+        /**
+         * @brief Was reached during the last marking phase of garbage collection
+         *
+         */
+        bool m_marked = false;
+
+        MemoryNodeKind m_kind;
+
+        /**
+         * @brief Amount of pins held by native code
+         *
+         */
         int32_t m_refCount = 0;
     };
 
     class StringNode : public MemoryNode
     {
     public:
-        explicit StringNode(std::string const &str) : m_str(str) {}
+        explicit StringNode(std::string const &str) : MemoryNode(nodeKind()), m_str(str) {}
+
+        static MemoryNodeKind nodeKind() { return MemoryNodeKinds::String; }
 
         std::string const &getString() { return m_str; }
 
+        /**
+         * @brief Get hash of the string. Hash is calculated on first use and cached until the string is changed
+         *
+         * @return size_t
+         */
+        size_t getHash();
+
+        /**
+         * @brief Is this string stored in the string interning table of the machine
+         *
+         * @return true
+         * @return false
+         */
+        bool isInterned() const { return m_interned; }
+
+        void setInterned(bool interned) { m_interned = interned; }
+
         std::string toString(bool pretty) override;
 
         char getCharAt(size_t ind);
@@ -121,6 +261,25 @@ namespace GobLang
 
     private:
         std::string m_str;
+        size_t m_hash = 0;
+        bool m_hashValid = false;
+        bool m_interned = false;
     };
 
+    /**
+     * @brief Get object stored in the value if value stores object of the given type
+     *
+     * @tparam T Type of the object
+     * @param value Value to get object from
+     * @return T* Object or nullptr if value is not an object or object is of different type
+     */
+    template <typename T>
+    T *getValueObject(MemoryValue const &value)
+    {
+        if (value.type != Type::MemoryObj || value.value.object == nullptr)
+        {
+            return nullptr;
+        }
+        return value.value.object->as<T>();
+    }
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <cstdint>
+#include "Type.hpp"
 namespace GobLang
 {
     enum class Operation
@@ -17,8 +18,26 @@ namespace GobLang
          * @brief Call a function defined by the user
          */
         CallLocal,
+        /**
+         * @brief Call a native function. First byte is id of the function in the native table of the byte code, second byte is the amount of arguments
+         */
+        CallNative,
+        /**
+         * @brief Set global variable using name string from the stack
+         */
         Set,
+        /**
+         * @brief Get global variable using name string from the stack
+         */
         Get,
+        /**
+         * @brief Set global variable stored in the slot given by the next byte
+         */
+        SetGlobal,
+        /**
+         * @brief Get global variable stored in the slot given by the next byte
+         */
+        GetGlobal,
         GetLocal,
         SetLocal,
         /**
@@ -61,6 +80,20 @@ namespace GobLang
          * @brief Jump only if the last operation on stack is false. Uses sizeof(size_t) bytes to get the address to jump to
          */
         JumpIfNot,
+        /**
+         * @brief Jump only if the last operation on stack is true. Uses sizeof(size_t) bytes to get the address to jump to
+         */
+        JumpIf,
+        /**
+         * @brief If the value on top of the stack is false, keep it and jump, otherwise remove it and continue.
+         * Uses sizeof(size_t) bytes to store jump distance counted from the end of this operation. Used for `&&`
+         */
+        JumpIfNotOrPop,
+        /**
+         * @brief If the value on top of the stack is true, keep it and jump, otherwise remove it and continue.
+         * Uses sizeof(size_t) bytes to store jump distance counted from the end of this operation. Used for `||`
+         */
+        JumpIfOrPop,
         /**
          * @brief Shrink local variable array by n variables
          */
@@ -77,73 +110,361 @@ namespace GobLang
          * @brief Create an array of size n using values from stack. Exists to provide a native way to make arrays
          */
         CreateArray,
+        /**
+         * @brief Set local variable value without removing the value from the stack. Uses 1 byte for local id. Replaces `set x; get x` sequence
+         */
+        SetLocalKeep,
+        /**
+         * @brief Add constant to a local variable without using the stack. Uses 1 byte for local id followed by 4 bytes of the int value.
+         * Replaces `get x; push_int n; add; set x` sequence
+         */
+        IncrementLocal,
+        /**
+         * @brief Compare two local variables and jump if comparison is false. Uses 1 byte for each local id, 1 byte for comparison operation
+         * and sizeof(size_t) bytes for the address. Replaces `get a; get b; <cmp>; goto_if_not addr` sequence
+         */
+        JumpIfNotCompareLocals,
+        /**
+         * @brief Compare local variable with constant int and jump if comparison is false. Uses 1 byte for local id, 4 bytes for the int value,
+         * 1 byte for comparison operation and sizeof(size_t) bytes for the address. Replaces `get a; push_int n; <cmp>; goto_if_not addr` sequence
+         */
+        JumpIfNotCompareLocalConst,
+        /**
+         * @brief Get array value using local variable as array and index from the stack. Uses 1 byte for local id. Replaces `get a; get_arr` sequence
+         */
+        GetArrayLocal,
+        /**
+         * @brief Apply arithmetic operation to local variable and value from the stack, storing result in the variable.
+         * Uses 1 byte for local id and 1 byte for the operation. Replaces `get x; <value>; <op>; set x` sequence
+         */
+        OperateLocal,
+        /**
+         * @brief Apply arithmetic operation to global variable and value from the stack, storing result in the variable.
+         * Uses 1 byte for global slot and 1 byte for the operation. Replaces `get_global x; <value>; <op>; set_global x` sequence
+         */
+        OperateGlobal,
+        /**
+         * @brief Apply arithmetic operation to array item and value from the stack, storing result in the array.
+         * Uses 1 byte for the operation and takes index, array and value from the stack in the same order as `set_arr`,
+         * which means that array and index are only calculated once
+         */
+        OperateArray,
+        /**
+         * @brief Add two ints. Machine replaces `add` with this operation once it sees int operands and switches back if types change
+         */
+        AddInt,
+        /**
+         * @brief Subtract two ints. Specialized version of `sub`
+         */
+        SubInt,
+        /**
+         * @brief Multiply two ints. Specialized version of `mul`
+         */
+        MulInt,
+        /**
+         * @brief Divide two ints. Specialized version of `div`
+         */
+        DivInt,
+        /**
+         * @brief Add two floats. Specialized version of `add`
+         */
+        AddFloat,
+        /**
+         * @brief Subtract two floats. Specialized version of `sub`
+         */
+        SubFloat,
+        /**
+         * @brief Multiply two floats. Specialized version of `mul`
+         */
+        MulFloat,
+        /**
+         * @brief Divide two floats. Specialized version of `div`
+         */
+        DivFloat,
+        /**
+         * @brief Check if int is less than other int. Specialized version of `less`, which also performs `goto_if_not` if it follows this operation
+         */
+        LessInt,
+        /**
+         * @brief Check if int is more than other int. Specialized version of `more`, which also performs `goto_if_not` if it follows this operation
+         */
+        MoreInt,
+        /**
+         * @brief Check if int is less or equal to other int. Specialized version of `eqless`, which also performs `goto_if_not` if it follows this operation
+         */
+        LessOrEqInt,
+        /**
+         * @brief Check if int is more or equal to other int. Specialized version of `eqmore`, which also performs `goto_if_not` if it follows this operation
+         */
+        MoreOrEqInt,
+        /**
+         * @brief Check if float is less than other float. Specialized version of `less`, which also performs `goto_if_not` if it follows this operation
+         */
+        LessFloat,
+        /**
+         * @brief Check if float is more than other float. Specialized version of `more`, which also performs `goto_if_not` if it follows this operation
+         */
+        MoreFloat,
+        /**
+         * @brief Check if float is less or equal to other float. Specialized version of `eqless`, which also performs `goto_if_not` if it follows this operation
+         */
+        LessOrEqFloat,
+        /**
+         * @brief Check if float is more or equal to other float. Specialized version of `eqmore`, which also performs `goto_if_not` if it follows this operation
+         */
+        MoreOrEqFloat,
+        /**
+         * @brief Call function defined in the code, replacing the frame of the current function instead of adding a new one.
+         * Uses 1 byte for function id. Replaces `call_local f; ret_val` sequence, so function returns directly to the caller of the current function
+         */
+        TailCallLocal,
+        /**
+         * @brief Same as `get_arr`, but without checking type of the index and bounds of the array.
+         * Only used when compiler can prove that index is an int inside of the array
+         */
+        GetArrayUnchecked,
+        /**
+         * @brief Same as `get_arr_local`, but without checking type of the index and bounds of the array.
+         * Uses 1 byte for local variable id
+         */
+        GetArrayLocalUnchecked,
+        /**
+         * @brief Same as `set_arr`, but without checking type of the index and bounds of the array
+         */
+        SetArrayUnchecked,
+        /**
+         * @brief Check that the value at the top of the stack is a bool, without changing it
+         */
+        CheckBool,
         /**
          * @brief End program execution
          */
         End
     };
 
+    /**
+     * @brief Check if operation compares two values and produces a bool
+     *
+     */
+    inline bool isComparisonOperation(Operation op)
+    {
+        return op == Operation::Equals || op == Operation::NotEq ||
+               op == Operation::Less || op == Operation::More ||
+               op == Operation::LessOrEq || op == Operation::MoreOrEq;
+    }
+
+    /**
+     * @brief Check if operation is arithmetic or bitwise operation that takes two values and can be used in combined assignment
+     *
+     */
+    inline bool isArithmeticOperation(Operation op)
+    {
+        return op == Operation::Add || op == Operation::Sub ||
+               op == Operation::Mul || op == Operation::Div ||
+               op == Operation::Modulo || op == Operation::BitAnd ||
+               op == Operation::BitOr || op == Operation::BitXor ||
+               op == Operation::ShiftLeft || op == Operation::ShiftRight;
+    }
+
+    /**
+     * @brief Get generic version of an operation that was specialized for ints or floats. Other operations are returned as is
+     *
+     */
+    inline Operation getGenericOperation(Operation op)
+    {
+        switch (op)
+        {
+        case Operation::AddInt:
+        case Operation::AddFloat:
+            return Operation::Add;
+        case Operation::SubInt:
+        case Operation::SubFloat:
+            return Operation::Sub;
+        case Operation::MulInt:
+        case Operation::MulFloat:
+            return Operation::Mul;
+        case Operation::DivInt:
+        case Operation::DivFloat:
+            return Operation::Div;
+        case Operation::LessInt:
+        case Operation::LessFloat:
+            return Operation::Less;
+        case Operation::MoreInt:
+        case Operation::MoreFloat:
+            return Operation::More;
+        case Operation::LessOrEqInt:
+        case Operation::LessOrEqFloat:
+            return Operation::LessOrEq;
+        case Operation::MoreOrEqInt:
+        case Operation::MoreOrEqFloat:
+            return Operation::MoreOrEq;
+        default:
+            return op;
+        }
+    }
+
+    /**
+     * @brief Get version of the operation specialized for the given type of both operands. If there is no such version the operation is returned as is
+     *
+     */
+    inline Operation getSpecializedOperation(Operation op, Type type)
+    {
+        if (type != Type::Int && type != Type::Float)
+        {
+            return op;
+        }
+        bool isInt = type == Type::Int;
+        switch (op)
+        {
+        case Operation::Add:
+            return isInt ? Operation::AddInt : Operation::AddFloat;
+        case Operation::Sub:
+            return isInt ? Operation::SubInt : Operation::SubFloat;
+        case Operation::Mul:
+            return isInt ? Operation::MulInt : Operation::MulFloat;
+        case Operation::Div:
+            return isInt ? Operation::DivInt : Operation::DivFloat;
+        case Operation::Less:
+            return isInt ? Operation::LessInt : Operation::LessFloat;
+        case Operation::More:
+            return isInt ? Operation::MoreInt : Operation::MoreFloat;
+        case Operation::LessOrEq:
+            return isInt ? Operation::LessOrEqInt : Operation::LessOrEqFloat;
+        case Operation::MoreOrEq:
+            return isInt ? Operation::MoreOrEqInt : Operation::MoreOrEqFloat;
+        default:
+            return op;
+        }
+    }
+
     enum class OperatorArgType
     {
-        None,
         Char,
         Byte,
         Address,
+        /**
+         * @brief Jump distance counted from the end of the operation
+         */
+        RelativeAddress,
         Int,
         UnsignedInt,
-        Float
+        Float,
+        /**
+         * @brief Byte storing code of the operation used by the instruction
+         */
+        Operation
     };
 
+    /**
+     * @brief Get how many bytes the argument of this type takes in the byte code
+     *
+     */
+    inline size_t getOperatorArgSize(OperatorArgType type)
+    {
+        switch (type)
+        {
+        case OperatorArgType::Int:
+            return sizeof(int32_t);
+        case OperatorArgType::UnsignedInt:
+            return sizeof(uint32_t);
+        case OperatorArgType::Float:
+            return sizeof(float);
+        case OperatorArgType::Address:
+        case OperatorArgType::RelativeAddress:
+            return sizeof(size_t);
+        default:
+            return sizeof(uint8_t);
+        }
+    }
+
     struct OperationData
     {
         Operation op;
         const char *text;
-        OperatorArgType argType;
+        /**
+         * @brief Types of the values stored after the operation in the order they appear in the byte code
+         */
+        std::vector<OperatorArgType> args;
     };
 
     static const std::vector<OperationData> Operations = {
-        OperationData{.op = Operation::None, .text = "noop", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::BitAnd, .text = "bit_and", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::BitOr, .text = "bit_or", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::BitXor, .text = "bit_xor", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::BitNot, .text = "bit_not", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::ShiftLeft, .text = "shift_left", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::ShiftRight, .text = "shift_right", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::Add, .text = "add", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::Sub, .text = "sub", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::Mul, .text = "mul", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::Div, .text = "div", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::Modulo, .text = "mod", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::Call, .text = "call", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::CallLocal, .text = "call_local", .argType = OperatorArgType::Byte},
-        OperationData{.op = Operation::CreateArray, .text = "create_array", .argType = OperatorArgType::Byte},
-        OperationData{.op = Operation::Set, .text = "set_global", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::Get, .text = "get_global", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::SetLocal, .text = "set", .argType = OperatorArgType::Byte},
-        OperationData{.op = Operation::GetLocal, .text = "get", .argType = OperatorArgType::Byte},
-        OperationData{.op = Operation::SetArray, .text = "set_arr", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::GetArray, .text = "get_arr", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::PushConstInt, .text = "push_int", .argType = OperatorArgType::Int},
-        OperationData{.op = Operation::PushConstUnsignedInt, .text = "push_uint", .argType = OperatorArgType::UnsignedInt},
-        OperationData{.op = Operation::PushConstFloat, .text = "push_float", .argType = OperatorArgType::Float},
-        OperationData{.op = Operation::PushConstChar, .text = "push_char", .argType = OperatorArgType::Char},
-        OperationData{.op = Operation::PushConstString, .text = "push_str", .argType = OperatorArgType::Byte},
-        OperationData{.op = Operation::PushTrue, .text = "push_true", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::PushFalse, .text = "push_false", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::PushNull, .text = "push_null", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::Equals, .text = "eq", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::NotEq, .text = "neq", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::Not, .text = "not", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::Negate, .text = "negate", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::More, .text = "more", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::Less, .text = "less", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::MoreOrEq, .text = "eqmore", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::LessOrEq, .text = "eqless", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::Jump, .text = "goto", .argType = OperatorArgType::Address},
-        OperationData{.op = Operation::JumpIfNot, .text = "goto_if_not", .argType = OperatorArgType::Address},
-        OperationData{.op = Operation::ShrinkLocal, .text = "local_free", .argType = OperatorArgType::Byte},
-        OperationData{.op = Operation::Return, .text = "ret", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::ReturnValue, .text = "ret_val", .argType = OperatorArgType::None},
-        OperationData{.op = Operation::End, .text = "hlt", .argType = OperatorArgType::None},
+        OperationData{.op = Operation::None, .text = "noop", .args = {}},
+        OperationData{.op = Operation::BitAnd, .text = "bit_and", .args = {}},
+        OperationData{.op = Operation::BitOr, .text = "bit_or", .args = {}},
+        OperationData{.op = Operation::BitXor, .text = "bit_xor", .args = {}},
+        OperationData{.op = Operation::BitNot, .text = "bit_not", .args = {}},
+        OperationData{.op = Operation::ShiftLeft, .text = "shift_left", .args = {}},
+        OperationData{.op = Operation::ShiftRight, .text = "shift_right", .args = {}},
+        OperationData{.op = Operation::Add, .text = "add", .args = {}},
+        OperationData{.op = Operation::Sub, .text = "sub", .args = {}},
+        OperationData{.op = Operation::Mul, .text = "mul", .args = {}},
+        OperationData{.op = Operation::Div, .text = "div", .args = {}},
+        OperationData{.op = Operation::Modulo, .text = "mod", .args = {}},
+        OperationData{.op = Operation::Call, .text = "call", .args = {}},
+        OperationData{.op = Operation::CallLocal, .text = "call_local", .args = {OperatorArgType::Byte}},
+        OperationData{.op = Operation::CallNative, .text = "call_native", .args = {OperatorArgType::Byte, OperatorArgType::Byte}},
+        OperationData{.op = Operation::CreateArray, .text = "create_array", .args = {OperatorArgType::Byte}},
+        OperationData{.op = Operation::Set, .text = "set_named", .args = {}},
+        OperationData{.op = Operation::Get, .text = "get_named", .args = {}},
+        OperationData{.op = Operation::SetGlobal, .text = "set_global", .args = {OperatorArgType::Byte}},
+        OperationData{.op = Operation::GetGlobal, .text = "get_global", .args = {OperatorArgType::Byte}},
+        OperationData{.op = Operation::SetLocal, .text = "set", .args = {OperatorArgType::Byte}},
+        OperationData{.op = Operation::GetLocal, .text = "get", .args = {OperatorArgType::Byte}},
+        OperationData{.op = Operation::SetArray, .text = "set_arr", .args = {}},
+        OperationData{.op = Operation::GetArray, .text = "get_arr", .args = {}},
+        OperationData{.op = Operation::PushConstInt, .text = "push_int", .args = {OperatorArgType::Int}},
+        OperationData{.op = Operation::PushConstUnsignedInt, .text = "push_uint", .args = {OperatorArgType::UnsignedInt}},
+        OperationData{.op = Operation::PushConstFloat, .text = "push_float", .args = {OperatorArgType::Float}},
+        OperationData{.op = Operation::PushConstChar, .text = "push_char", .args = {OperatorArgType::Char}},
+        OperationData{.op = Operation::PushConstString, .text = "push_str", .args = {OperatorArgType::Byte}},
+        OperationData{.op = Operation::PushTrue, .text = "push_true", .args = {}},
+        OperationData{.op = Operation::PushFalse, .text = "push_false", .args = {}},
+        OperationData{.op = Operation::PushNull, .text = "push_null", .args = {}},
+        OperationData{.op = Operation::Equals, .text = "eq", .args = {}},
+        OperationData{.op = Operation::NotEq, .text = "neq", .args = {}},
+        OperationData{.op = Operation::Not, .text = "not", .args = {}},
+        OperationData{.op = Operation::Negate, .text = "negate", .args = {}},
+        OperationData{.op = Operation::More, .text = "more", .args = {}},
+        OperationData{.op = Operation::Less, .text = "less", .args = {}},
+        OperationData{.op = Operation::MoreOrEq, .text = "eqmore", .args = {}},
+        OperationData{.op = Operation::LessOrEq, .text = "eqless", .args = {}},
+        OperationData{.op = Operation::Jump, .text = "goto", .args = {OperatorArgType::Address}},
+        OperationData{.op = Operation::JumpIfNot, .text = "goto_if_not", .args = {OperatorArgType::Address}},
+        OperationData{.op = Operation::JumpIf, .text = "goto_if", .args = {OperatorArgType::Address}},
+        OperationData{.op = Operation::JumpIfNotOrPop, .text = "goto_if_not_or_pop", .args = {OperatorArgType::RelativeAddress}},
+        OperationData{.op = Operation::JumpIfOrPop, .text = "goto_if_or_pop", .args = {OperatorArgType::RelativeAddress}},
+        OperationData{.op = Operation::ShrinkLocal, .text = "local_free", .args = {OperatorArgType::Byte}},
+        OperationData{.op = Operation::Return, .text = "ret", .args = {}},
+        OperationData{.op = Operation::ReturnValue, .text = "ret_val", .args = {}},
+        OperationData{.op = Operation::SetLocalKeep, .text = "set_keep", .args = {OperatorArgType::Byte}},
+        OperationData{.op = Operation::IncrementLocal, .text = "inc_local", .args = {OperatorArgType::Byte, OperatorArgType::Int}},
+        OperationData{.op = Operation::JumpIfNotCompareLocals, .text = "cmp_locals_goto_if_not", .args = {OperatorArgType::Byte, OperatorArgType::Byte, OperatorArgType::Operation, OperatorArgType::Address}},
+        OperationData{.op = Operation::JumpIfNotCompareLocalConst, .text = "cmp_local_int_goto_if_not", .args = {OperatorArgType::Byte, OperatorArgType::Int, OperatorArgType::Operation, OperatorArgType::Address}},
+        OperationData{.op = Operation::GetArrayLocal, .text = "get_arr_local", .args = {OperatorArgType::Byte}},
+        OperationData{.op = Operation::OperateLocal, .text = "op_local", .args = {OperatorArgType::Byte, OperatorArgType::Operation}},
+        OperationData{.op = Operation::OperateGlobal, .text = "op_global", .args = {OperatorArgType::Byte, OperatorArgType::Operation}},
+        OperationData{.op = Operation::OperateArray, .text = "op_arr", .args = {OperatorArgType::Operation}},
+        OperationData{.op = Operation::AddInt, .text = "add_int", .args = {}},
+        OperationData{.op = Operation::SubInt, .text = "sub_int", .args = {}},
+        OperationData{.op = Operation::MulInt, .text = "mul_int", .args = {}},
+        OperationData{.op = Operation::DivInt, .text = "div_int", .args = {}},
+        OperationData{.op = Operation::AddFloat, .text = "add_float", .args = {}},
+        OperationData{.op = Operation::SubFloat, .text = "sub_float", .args = {}},
+        OperationData{.op = Operation::MulFloat, .text = "mul_float", .args = {}},
+        OperationData{.op = Operation::DivFloat, .text = "div_float", .args = {}},
+        OperationData{.op = Operation::LessInt, .text = "less_int", .args = {}},
+        OperationData{.op = Operation::MoreInt, .text = "more_int", .args = {}},
+        OperationData{.op = Operation::LessOrEqInt, .text = "eqless_int", .args = {}},
+        OperationData{.op = Operation::MoreOrEqInt, .text = "eqmore_int", .args = {}},
+        OperationData{.op = Operation::LessFloat, .text = "less_float", .args = {}},
+        OperationData{.op = Operation::MoreFloat, .text = "more_float", .args = {}},
+        OperationData{.op = Operation::LessOrEqFloat, .text = "eqless_float", .args = {}},
+        OperationData{.op = Operation::MoreOrEqFloat, .text = "eqmore_float", .args = {}},
+        OperationData{.op = Operation::TailCallLocal, .text = "tail_call_local", .args = {OperatorArgType::Byte}},
+        OperationData{.op = Operation::GetArrayUnchecked, .text = "get_arr_unchecked", .args = {}},
+        OperationData{.op = Operation::GetArrayLocalUnchecked, .text = "get_arr_local_unchecked", .args = {OperatorArgType::Byte}},
+        OperationData{.op = Operation::SetArrayUnchecked, .text = "set_arr_unchecked", .args = {}},
+        OperationData{.op = Operation::CheckBool, .text = "check_bool", .args = {}},
+        OperationData{.op = Operation::End, .text = "hlt", .args = {}},
     };
 } // namespace SimpleLang
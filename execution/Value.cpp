@@ -12,20 +12,19 @@ bool GobLang::areEqual(MemoryValue const &a, MemoryValue const &b)
     case Type::Null:
         return true;
     case Type::Bool:
-        return std::get<bool>(a.value) == std::get<bool>(b.value);
+        return a.value.boolean == b.value.boolean;
     case Type::Float:
-        return std::get<float>(a.value) == std::get<float>(b.value);
+        return a.value.floating == b.value.floating;
     case Type::Int:
-        return std::get<int32_t>(a.value) == std::get<int32_t>(b.value);
+        return a.value.integer == b.value.integer;
     case Type::UnsignedInt:
-        return std::get<uint32_t>(a.value) == std::get<uint32_t>(b.value);
+        return a.value.unsignedInteger == b.value.unsignedInteger;
     case Type::Char:
-        return std::get<char>(a.value) == std::get<char>(b.value);
+        return a.value.character == b.value.character;
     case Type::MemoryObj:
-        return std::get<MemoryNode *>(a.value)->equalsTo(std::get<MemoryNode *>(b.value));
+        return a.value.object->equalsTo(b.value.object);
     case Type::NativeFunction:
-        // c++ has no equality check for std::function
-        return false;
+        return a.value.nativeFunction == b.value.nativeFunction;
     }
     return false;
 }
@@ -37,17 +36,17 @@ std::string GobLang::valueToString(MemoryValue const &val, bool pretty)
     case Type::Null:
         return "null";
     case Type::Bool:
-        return std::get<bool>(val.value) ? "true" : "false";
+        return val.value.boolean ? "true" : "false";
     case Type::Float:
-        return std::to_string(std::get<float>(val.value));
+        return std::to_string(val.value.floating);
     case Type::Int:
-        return std::to_string(std::get<int32_t>(val.value));
+        return std::to_string(val.value.integer);
     case Type::UnsignedInt:
-        return std::to_string(std::get<uint32_t>(val.value));
+        return std::to_string(val.value.unsignedInteger);
     case Type::MemoryObj:
-        return std::get<MemoryNode *>(val.value)->toString(pretty);
+        return val.value.object->toString(pretty);
     case Type::Char:
-        return std::string{std::get<char>(val.value)};
+        return std::string{val.value.character};
     case Type::NativeFunction:
         // c++ has no equality check for std::function
         return "Native function";
@@ -2,7 +2,7 @@
 #include <vector>
 #include <cstdint>
 #include <functional>
-#include <variant>
+#include <type_traits>
 #include <string>
 #include "Type.hpp"
 
@@ -11,14 +11,43 @@ namespace GobLang
     class Machine;
     class MemoryNode;
     using FunctionValue = std::function<void(Machine *)>;
-    using Value = std::variant<bool, char, float, int32_t, uint32_t, MemoryNode *, FunctionValue>;
+
+    /**
+     * @brief Payload of a memory value. Which member is active is determined by the type stored alongside it
+     *
+     */
+    union Value
+    {
+        Value() : integer(0) {}
+        Value(bool val) : boolean(val) {}
+        Value(char val) : character(val) {}
+        Value(float val) : floating(val) {}
+        Value(int32_t val) : integer(val) {}
+        Value(uint32_t val) : unsignedInteger(val) {}
+        Value(MemoryNode *val) : object(val) {}
+
+        bool boolean;
+        char character;
+        float floating;
+        int32_t integer;
+        uint32_t unsignedInteger;
+        MemoryNode *object;
+        /**
+         * @brief Index of the function in the native function table of the machine
+         *
+         */
+        uint32_t nativeFunction;
+    };
 
     struct MemoryValue
     {
-        Type type;
+        Type type = Type::Null;
         Value value;
     };
 
+    static_assert(sizeof(MemoryValue) <= 16, "Memory values are expected to fit into 16 bytes");
+    static_assert(std::is_trivially_copyable_v<MemoryValue>, "Memory values must be copyable without running any code");
+
     /**
      * @brief Compare two memory values and validate that both are equal
      *
@@ -36,6 +36,11 @@ int main()
     rev.printCode();
     rev.printFunctions();
     GobLang::Compiler::Compiler compiler(rev);
+    std::vector<std::string> nativeNames = MachineFunctions::getFunctionNames();
+    for (std::string const &name : nativeNames)
+    {
+        compiler.declareNativeFunction(name, MachineFunctions::getFunctionEffect(name));
+    }
     compiler.generateByteCode();
     // compiler.printLocalFunctionInfo();
     GobLang::Compiler::byteCodeToText(compiler.getByteCode().operations);
@@ -43,17 +48,21 @@ int main()
     GobLang::Machine machine(compiler.getByteCode());
     MachineFunctions::bind(&machine);
     std::vector<size_t> debugPoints = {};
+    for (size_t point : debugPoints)
+    {
+        machine.addBreakpoint(point);
+    }
     while (!machine.isAtTheEnd())
     {
-        if (std::find(debugPoints.begin(), debugPoints.end(), machine.getProgramCounter()) != debugPoints.end())
+        machine.run();
+        if (!machine.isAtTheEnd())
         {
             std::cout << "Debugging at " << std::hex << machine.getProgramCounter() << std::dec << ". Memory state: " << std::endl;
             machine.printGlobalsInfo();
             machine.printVariablesInfo();
             machine.printStack();
         }
-        machine.step();
     }
-    // std::cout << "Value of a = " << std::get<int32_t>(machine.getVariableValue("a").value) << std::endl;
+    // std::cout << "Value of a = " << machine.getVariableValue("a").value.integer << std::endl;
     return EXIT_SUCCESS;
 }
\ No newline at end of file
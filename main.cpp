@@ -14,6 +14,7 @@
 #include "compiler/ReversePolishGenerator.hpp"
 #include "compiler/Validator.hpp"
 #include "compiler/Compiler.hpp"
+#include "compiler/PeepholeOptimizer.hpp"
 #include "execution/Machine.hpp"
 
 #include "execution/Machine.hpp"
@@ -27,6 +28,7 @@ int main(int argc, char **argv)
     std::vector<std::string> HelpArgs = {"-h", "--help"};
     std::vector<std::string> FileArgs = {"-i", "--input"};
     std::vector<std::string> DecompArgs = {"-s", "--showbytes"};
+    std::vector<std::string> OptimizeArgs = {"-O", "--optimize"};
     std::vector<std::string> args;
     for (int i = 0; i < argc; i++)
     {
@@ -48,6 +50,7 @@ int main(int argc, char **argv)
         std::cout << "-h | --help       : View help about the interpreter" << std::endl;
         std::cout << "-i | --input      : Run code from file in a given location" << std::endl;
         std::cout << "-s | --showbytes  : Show bytecode before running code" << std::endl;
+        std::cout << "-O | --optimize   : Optimize bytecode before running code" << std::endl;
         return EXIT_SUCCESS;
     }
 
@@ -86,25 +89,42 @@ int main(int argc, char **argv)
         GobLang::Compiler::ReversePolishGenerator generator(comp);
         generator.compile();
         GobLang::Compiler::Compiler compiler(generator);
+        std::vector<std::string> nativeNames = MachineFunctions::getFunctionNames();
+        for (std::string const &name : nativeNames)
+        {
+            compiler.declareNativeFunction(name, MachineFunctions::getFunctionEffect(name));
+        }
         compiler.generateByteCode();
+        GobLang::Compiler::ByteCode code = compiler.getByteCode();
+        verIt = std::find_first_of(args.begin(), args.end(), OptimizeArgs.begin(), OptimizeArgs.end());
+        if (verIt != args.end())
+        {
+            GobLang::Compiler::PeepholeOptimizer optimizer(code);
+            optimizer.optimize();
+            code = optimizer.getByteCode();
+        }
         verIt = std::find_first_of(args.begin(), args.end(), DecompArgs.begin(), DecompArgs.end());
         if (verIt != args.end())
         {
-            GobLang::Compiler::byteCodeToText(compiler.getByteCode().operations);
+            GobLang::Compiler::byteCodeToText(code.operations);
         }
-        GobLang::Machine machine(compiler.getByteCode());
+        GobLang::Machine machine(code);
         MachineFunctions::bind(&machine);
         std::vector<size_t> debugPoints = {};
+        for (size_t point : debugPoints)
+        {
+            machine.addBreakpoint(point);
+        }
         while (!machine.isAtTheEnd())
         {
-            if (std::find(debugPoints.begin(), debugPoints.end(), machine.getProgramCounter()) != debugPoints.end())
+            machine.run();
+            if (!machine.isAtTheEnd())
             {
                 std::cout << "Debugging at " << std::hex << machine.getProgramCounter() << std::dec << std::endl;
                 machine.printGlobalsInfo();
                 machine.printVariablesInfo();
                 machine.printStack();
             }
-            machine.step();
         }
     }
     catch (GobLang::Compiler::ParsingError e)
@@ -127,6 +147,11 @@ int main(int argc, char **argv)
         }
         std::cout << e.what() << std::endl;
     }
+    catch (GobLang::Compiler::CompilerException const &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
     catch (GobLang::RuntimeException e)
     {
         std::cerr << e.what() << std::endl;
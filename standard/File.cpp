@@ -1,6 +1,6 @@
 #include "File.hpp"
 
-MachineFunctions::File::FileNode::FileNode(std::string const &path, bool read)
+MachineFunctions::File::FileNode::FileNode(std::string const &path, bool read) : GobLang::MemoryNode(nodeKind())
 {
     if (read)
     {
@@ -37,6 +37,12 @@ MachineFunctions::File::FileNode::~FileNode()
     }
 }
 
+GobLang::MemoryNodeKind MachineFunctions::File::FileNode::nodeKind()
+{
+    static const GobLang::MemoryNodeKind kind = GobLang::registerMemoryNodeKind();
+    return kind;
+}
+
 void MachineFunctions::File::openFile(GobLang::Machine *m)
 {
     using namespace GobLang;
@@ -50,9 +56,9 @@ void MachineFunctions::File::openFile(GobLang::Machine *m)
     {
         throw RuntimeException("Missing value for file read mode. Requires true for read and false for write");
     }
-    if (StringNode *str = dynamic_cast<StringNode *>(std::get<MemoryNode *>(path->value)); str != nullptr)
+    if (StringNode *str = getValueObject<StringNode>(*path); str != nullptr)
     {
-        FileNode *f = new FileNode(str->getString(), std::get<bool>(read->value));
+        FileNode *f = new FileNode(str->getString(), read->value.boolean);
         m->addObject(f);
         m->pushToStack(MemoryValue{.type = Type::MemoryObj, .value = f});
     }
@@ -72,7 +78,7 @@ void MachineFunctions::File::closeFile(GobLang::Machine *m)
     {
         throw RuntimeException("Expected file handle object");
     }
-    if (FileNode *fileNode = dynamic_cast<FileNode *>(std::get<MemoryNode *>(file->value)))
+    if (FileNode *fileNode = getValueObject<FileNode>(*file))
     {
         fileNode->close();
         delete file;
@@ -91,7 +97,7 @@ void MachineFunctions::File::isFileOpen(GobLang::Machine *m)
     {
         throw RuntimeException("Expected file handle object");
     }
-    if (FileNode *fileNode = dynamic_cast<FileNode *>(std::get<MemoryNode *>(file->value)))
+    if (FileNode *fileNode = getValueObject<FileNode>(*file))
     {
         m->pushToStack(MemoryValue{.type = Type::Bool, .value = fileNode->isOpen()});
         delete file;
@@ -119,7 +125,7 @@ void MachineFunctions::File::writeToFile(GobLang::Machine *m)
     {
         throw RuntimeException("Expected file handle object");
     }
-    if (FileNode *fileNode = dynamic_cast<FileNode *>(std::get<MemoryNode *>(file->value)))
+    if (FileNode *fileNode = getValueObject<FileNode>(*file))
     {
         fileNode->writeToFile(valueToString(*text, false));
         delete file;
@@ -139,7 +145,7 @@ void MachineFunctions::File::readLineFromFile(GobLang::Machine *m)
     {
         throw RuntimeException("Expected file handle object");
     }
-    if (FileNode *fileNode = dynamic_cast<FileNode *>(std::get<MemoryNode *>(file->value)))
+    if (FileNode *fileNode = getValueObject<FileNode>(*file))
     {
 
         std::string str;
@@ -168,7 +174,7 @@ void MachineFunctions::File::isFileEnded(GobLang::Machine *m)
     {
         throw RuntimeException("Expected file handle object");
     }
-    if (FileNode *fileNode = dynamic_cast<FileNode *>(std::get<MemoryNode *>(file->value)))
+    if (FileNode *fileNode = getValueObject<FileNode>(*file))
     {
         m->pushToStack(MemoryValue{.type = Type::Bool, .value = fileNode->isEof()});
         delete file;
@@ -15,6 +15,8 @@ namespace MachineFunctions::File
     public:
         explicit FileNode(std::string const &path, bool read);
 
+        static GobLang::MemoryNodeKind nodeKind();
+
         void writeToFile(std::string const &str);
 
         void close();
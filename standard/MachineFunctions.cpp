@@ -3,26 +3,67 @@
 #include "../execution/Memory.hpp"
 #include "File.hpp"
 #include <random>
+#include <map>
+
+/// @brief All standard functions in the order they are registered in
+static const std::vector<std::pair<std::string, GobLang::FunctionValue>> StandardFunctions = {
+    {"sizeof", MachineFunctions::getSizeof},
+    {"print_line", MachineFunctions::printLine},
+    {"print", MachineFunctions::print},
+    {"str", MachineFunctions::toString},
+    {"array", MachineFunctions::createArrayOfSize},
+    {"append", MachineFunctions::append},
+    {"input", MachineFunctions::input},
+    {"int", MachineFunctions::Math::toInt},
+    {"float", MachineFunctions::Math::toFloat},
+    {"rand_range", MachineFunctions::Math::randomIntInRange},
+    {"rand", MachineFunctions::Math::randomInt},
+    {"file_open", MachineFunctions::File::openFile},
+    {"file_close", MachineFunctions::File::closeFile},
+    {"file_write", MachineFunctions::File::writeToFile},
+    {"file_is_open", MachineFunctions::File::isFileOpen},
+    {"file_read_line", MachineFunctions::File::readLineFromFile},
+    {"file_is_eof", MachineFunctions::File::isFileEnded},
+};
+
+/// @brief Effects of standard functions that don't change values. Functions that are not listed can change anything
+static const std::map<std::string, GobLang::Compiler::NativeFunctionEffect> StandardFunctionEffects = {
+    {"sizeof", GobLang::Compiler::NativeFunctionEffect::Pure},
+    {"print_line", GobLang::Compiler::NativeFunctionEffect::ReadOnly},
+    {"print", GobLang::Compiler::NativeFunctionEffect::ReadOnly},
+    {"str", GobLang::Compiler::NativeFunctionEffect::ReadOnly},
+    {"array", GobLang::Compiler::NativeFunctionEffect::ReadOnly},
+    {"input", GobLang::Compiler::NativeFunctionEffect::ReadOnly},
+    {"int", GobLang::Compiler::NativeFunctionEffect::ReadOnly},
+    {"float", GobLang::Compiler::NativeFunctionEffect::ReadOnly},
+    {"rand_range", GobLang::Compiler::NativeFunctionEffect::ReadOnly},
+    {"rand", GobLang::Compiler::NativeFunctionEffect::ReadOnly},
+};
+
 void MachineFunctions::bind(GobLang::Machine *machine)
 {
-    machine->addFunction(MachineFunctions::getSizeof, "sizeof");
-    machine->addFunction(MachineFunctions::printLine, "print_line");
-    machine->addFunction(MachineFunctions::print, "print");
-    machine->addFunction(MachineFunctions::toString, "str");
-    machine->addFunction(MachineFunctions::createArrayOfSize, "array");
-    machine->addFunction(MachineFunctions::append, "append");
-    machine->addFunction(MachineFunctions::input, "input");
-    machine->addFunction(MachineFunctions::Math::toInt, "int");
-    machine->addFunction(MachineFunctions::Math::toFloat, "float");
-    machine->addFunction(MachineFunctions::Math::randomIntInRange, "rand_range");
-    machine->addFunction(MachineFunctions::Math::randomInt, "rand");
-    machine->addFunction(MachineFunctions::File::openFile, "file_open");
-    machine->addFunction(MachineFunctions::File::closeFile, "file_close");
-    machine->addFunction(MachineFunctions::File::writeToFile, "file_write");
-    machine->addFunction(MachineFunctions::File::isFileOpen, "file_is_open");
-    machine->addFunction(MachineFunctions::File::readLineFromFile, "file_read_line");
-    machine->addFunction(MachineFunctions::File::isFileEnded, "file_is_eof");
+    for (std::vector<std::pair<std::string, GobLang::FunctionValue>>::const_iterator it = StandardFunctions.begin(); it != StandardFunctions.end(); it++)
+    {
+        machine->addFunction(it->second, it->first);
+    }
+}
+
+std::vector<std::string> MachineFunctions::getFunctionNames()
+{
+    std::vector<std::string> names;
+    for (std::vector<std::pair<std::string, GobLang::FunctionValue>>::const_iterator it = StandardFunctions.begin(); it != StandardFunctions.end(); it++)
+    {
+        names.push_back(it->first);
+    }
+    return names;
 }
+
+GobLang::Compiler::NativeFunctionEffect MachineFunctions::getFunctionEffect(std::string const &name)
+{
+    std::map<std::string, GobLang::Compiler::NativeFunctionEffect>::const_iterator it = StandardFunctionEffects.find(name);
+    return it == StandardFunctionEffects.end() ? GobLang::Compiler::NativeFunctionEffect::Any : it->second;
+}
+
 void MachineFunctions::printLine(GobLang::Machine *machine)
 
 {
@@ -53,7 +94,7 @@ void MachineFunctions::createArrayOfSize(GobLang::Machine *machine)
     GobLang::MemoryValue *sizeVal = machine->getStackTopAndPop();
     machine->pushToStack(GobLang::MemoryValue{
         .type = GobLang::Type::MemoryObj,
-        .value = machine->createArrayOfSize(std::get<int32_t>(sizeVal->value))});
+        .value = machine->createArrayOfSize(sizeVal->value.integer)});
     delete sizeVal;
 }
 
@@ -71,7 +112,7 @@ void MachineFunctions::append(GobLang::Machine *machine)
     {
         throw GobLang::RuntimeException("Missing value for the append operation");
     }
-    if (GobLang::ArrayNode *arrayNode = dynamic_cast<GobLang::ArrayNode *>(std::get<GobLang::MemoryNode *>(array->value)); arrayNode != nullptr)
+    if (GobLang::ArrayNode *arrayNode = GobLang::getValueObject<GobLang::ArrayNode>(*array); arrayNode != nullptr)
     {
         arrayNode->append(*val);
     }
@@ -86,11 +127,11 @@ void MachineFunctions::getSizeof(GobLang::Machine *machine)
     {
         throw GobLang::RuntimeException("Attempted to get a size of a non array object");
     }
-    if (GobLang::ArrayNode *arrayNode = dynamic_cast<GobLang::ArrayNode *>(std::get<GobLang::MemoryNode *>(array->value)); arrayNode != nullptr)
+    if (GobLang::ArrayNode *arrayNode = GobLang::getValueObject<GobLang::ArrayNode>(*array); arrayNode != nullptr)
     {
         machine->pushToStack(GobLang::MemoryValue{.type = GobLang::Type::Int, .value = (int32_t)arrayNode->getSize()});
     }
-    else if (GobLang::StringNode *strNode = dynamic_cast<GobLang::StringNode *>(std::get<GobLang::MemoryNode *>(array->value)); strNode != nullptr)
+    else if (GobLang::StringNode *strNode = GobLang::getValueObject<GobLang::StringNode>(*array); strNode != nullptr)
     {
         machine->pushToStack(GobLang::MemoryValue{.type = GobLang::Type::Int, .value = (int32_t)strNode->getSize()});
     }
@@ -130,12 +171,12 @@ void MachineFunctions::Math::toInt(GobLang::Machine *machine)
         machine->pushToStack(*value);
         break;
     case GobLang::Type::Float:
-        machine->pushToStack(MemoryValue{.type = Type::Int, .value = (int32_t)std::get<float>(value->value)});
+        machine->pushToStack(MemoryValue{.type = Type::Int, .value = (int32_t)value->value.floating});
         break;
     case GobLang::Type::MemoryObj:
         try
         {
-            if (StringNode *node = dynamic_cast<StringNode *>(std::get<MemoryNode *>(value->value)); node != nullptr)
+            if (StringNode *node = getValueObject<StringNode>(*value); node != nullptr)
             {
                 machine->pushToStack(MemoryValue{.type = Type::Int, .value = std::stoi(node->getString())});
                 break;
@@ -162,7 +203,7 @@ void MachineFunctions::Math::toFloat(GobLang::Machine *machine)
     switch (value->type)
     {
     case Type::Int:
-        machine->pushToStack(MemoryValue{.type = Type::Float, .value = (float)std::get<float>(value->value)});
+        machine->pushToStack(MemoryValue{.type = Type::Float, .value = (float)value->value.integer});
         break;
     case GobLang::Type::Float:
         machine->pushToStack(*value);
@@ -170,7 +211,7 @@ void MachineFunctions::Math::toFloat(GobLang::Machine *machine)
     case GobLang::Type::MemoryObj:
         try
         {
-            if (StringNode *node = dynamic_cast<StringNode *>(std::get<MemoryNode *>(value->value)); node != nullptr)
+            if (StringNode *node = getValueObject<StringNode>(*value); node != nullptr)
             {
                 machine->pushToStack(MemoryValue{.type = Type::Float, .value = std::stof(node->getString())});
                 break;
@@ -198,15 +239,15 @@ void MachineFunctions::Math::randomIntInRange(GobLang::Machine *machine)
     {
         throw GobLang::RuntimeException("Random value range values are not type int");
     }
-    int32_t minVal = std::get<int32_t>(min->value);
-    int32_t maxVal = std::get<int32_t>(max->value);
+    int32_t minVal = min->value.integer;
+    int32_t maxVal = max->value.integer;
     if (minVal >= maxVal)
     {
         throw GobLang::RuntimeException(std::string("Invalid random range. Min: " + std::to_string(minVal) + " max: " + std::to_string(maxVal)));
     }
     std::random_device rand_dev;
     std::mt19937 generator(rand_dev());
-    std::uniform_int_distribution<int32_t> distr(std::get<int32_t>(min->value), std::get<int32_t>(max->value));
+    std::uniform_int_distribution<int32_t> distr(min->value.integer, max->value.integer);
     machine->pushToStack(GobLang::MemoryValue{.type = GobLang::Type::Int, .value = distr(generator)});
 
     delete min;
@@ -13,6 +13,21 @@ namespace MachineFunctions
      */
     void bind(GobLang::Machine *machine);
 
+    /**
+     * @brief Get names of all functions registered by `bind`. Used to let compiler know which calls can be resolved to native functions
+     *
+     * @return std::vector<std::string> Names of the standard functions
+     */
+    std::vector<std::string> getFunctionNames();
+
+    /**
+     * @brief Get what compiler can assume about the standard function when optimizing the code
+     *
+     * @param name Name of the standard function
+     * @return GobLang::Compiler::NativeFunctionEffect Effect of the function or `Any` if there is no function with this name
+     */
+    GobLang::Compiler::NativeFunctionEffect getFunctionEffect(std::string const &name);
+
     void printLine(GobLang::Machine *machine);
 
     void print(GobLang::Machine *machine);
@@ -1,11 +1,133 @@
 #include <iostream>
 #include <cassert>
+#include <map>
+#include <algorithm>
 
 #include "compiler/Parser.hpp"
 #include "compiler/Validator.hpp"
+#include "compiler/ReversePolishGenerator.hpp"
+#include "compiler/Compiler.hpp"
+#include "compiler/InstructionList.hpp"
+#include "execution/Machine.hpp"
+#include "standard/MachineFunctions.hpp"
 
 using namespace GobLang::Compiler;
 
+/**
+ * @brief Compile the code with standard native functions declared
+ *
+ * @param code Code to compile
+ * @param natives Names of additional native functions with their effects
+ * @param disabledPasses Names of optimization passes that will not be applied
+ * @return ByteCode Resulting byte code
+ */
+ByteCode compileCode(std::string const &code, std::map<std::string, NativeFunctionEffect> const &natives = {}, std::vector<std::string> const &disabledPasses = {})
+{
+    Parser p(code);
+    p.parse();
+    Validator v(p);
+    v.validate();
+    ReversePolishGenerator generator(p);
+    generator.compile();
+    Compiler compiler(generator);
+    std::vector<std::string> nativeNames = MachineFunctions::getFunctionNames();
+    for (std::vector<std::string>::const_iterator it = nativeNames.begin(); it != nativeNames.end(); it++)
+    {
+        compiler.declareNativeFunction(*it, MachineFunctions::getFunctionEffect(*it));
+    }
+    for (std::map<std::string, NativeFunctionEffect>::const_iterator it = natives.begin(); it != natives.end(); it++)
+    {
+        compiler.declareNativeFunction(it->first, it->second);
+    }
+    for (std::vector<std::string>::const_iterator it = disabledPasses.begin(); it != disabledPasses.end(); it++)
+    {
+        assert(compiler.getPassManager().setPassEnabled(*it, false));
+    }
+    compiler.generateByteCode();
+    return compiler.getByteCode();
+}
+
+/**
+ * @brief Decode instructions of the main code or a function, skipping removed ones
+ *
+ * @param code Compiled code
+ * @param funcId Id of the function or -1 for the main code
+ * @return std::vector<Instruction> Remaining instructions
+ */
+std::vector<Instruction> getCode(ByteCode const &code, int32_t funcId = -1)
+{
+    InstructionList list;
+    assert(list.decode(code));
+    size_t start = funcId < 0 ? 0 : list.getFunctionStarts()[funcId];
+    std::vector<Instruction> result;
+    for (size_t i = start; i < list.getCodeEnd(start); i++)
+    {
+        if (!list.getInstructions()[i].removed)
+        {
+            result.push_back(list.getInstructions()[i]);
+        }
+    }
+    return result;
+}
+
+size_t countOperation(std::vector<Instruction> const &code, GobLang::Operation op)
+{
+    return std::count_if(code.begin(), code.end(), [op](Instruction const &instr)
+                         { return instr.op == op; });
+}
+
+/**
+ * @brief Get index of the first instruction of the first loop, which is where the end of the loop jumps back to
+ *
+ */
+size_t getLoopStart(std::vector<Instruction> const &code)
+{
+    for (size_t i = 0; i < code.size(); i++)
+    {
+        if (code[i].op == GobLang::Operation::Jump && code[i].target < i)
+        {
+            return code[i].target;
+        }
+    }
+    assert(false);
+    return 0;
+}
+
+/**
+ * @brief Get indices of all calls to the native function with the given name
+ *
+ */
+std::vector<size_t> findNativeCalls(ByteCode const &byteCode, std::vector<Instruction> const &code, std::string const &name)
+{
+    std::vector<size_t> calls;
+    for (size_t i = 0; i < code.size(); i++)
+    {
+        if (code[i].op == GobLang::Operation::CallNative && byteCode.natives[code[i].args[0]] == name)
+        {
+            calls.push_back(i);
+        }
+    }
+    return calls;
+}
+
+/**
+ * @brief Run the code until the end and get value of the global variable
+ *
+ * @param code Code to run
+ * @param name Name of the global variable
+ * @return GobLang::MemoryValue Value of the variable, which must not be an object
+ */
+GobLang::MemoryValue runCode(ByteCode const &code, std::string const &name)
+{
+    GobLang::Machine machine(code);
+    MachineFunctions::bind(&machine);
+    while (!machine.isAtTheEnd())
+    {
+        machine.run();
+    }
+    return machine.getVariableValue(name);
+}
+
 void testBlock()
 {
     Parser p("{let c = a + (3 - 0); let g = wawa; wawa = (w / 2);}");
@@ -175,6 +297,432 @@ void testArrayCreationNest()
     Validator::TokenIterator endIt;
     assert(v.arrayCreation(p.getTokens().begin(), endIt));
 }
+void testGlobalLimit()
+{
+    std::string code;
+    for (size_t i = 0; i < 256; i++)
+    {
+        code += "g" + std::to_string(i) + " = " + std::to_string(i) + ";";
+    }
+    assert(compileCode(code).globals.size() == 256);
+    bool thrown = false;
+    try
+    {
+        compileCode(code + "g256 = 256;");
+    }
+    catch (CompilerException const &e)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void testNativeLimit()
+{
+    std::string code;
+    std::map<std::string, NativeFunctionEffect> natives;
+    for (size_t i = 0; i < 256; i++)
+    {
+        code += "n" + std::to_string(i) + "();";
+        natives["n" + std::to_string(i)] = NativeFunctionEffect::Any;
+    }
+    assert(compileCode(code, natives).natives.size() == 256);
+    natives["n256"] = NativeFunctionEffect::Any;
+    bool thrown = false;
+    try
+    {
+        compileCode(code + "n256();", natives);
+    }
+    catch (CompilerException const &e)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void testConstantFolding()
+{
+    // folded values must wrap around and round the same way as the runtime does
+    ByteCode code = compileCode("r = 2147483647 + 1;");
+    std::vector<Instruction> main = getCode(code);
+    assert(main[0].op == GobLang::Operation::PushConstInt && main[0].args == parseToBytes(INT32_MIN));
+    assert(runCode(code, "r").value.integer == INT32_MIN);
+    code = compileCode("r = -7 % 3;");
+    main = getCode(code);
+    assert(main[0].op == GobLang::Operation::PushConstInt && main[0].args == parseToBytes((int32_t)-1));
+    assert(runCode(code, "r").value.integer == -1);
+}
+
+void testConstantFoldingDivision()
+{
+    // invalid division is left in the code, so the error happens at runtime
+    ByteCode code = compileCode("r = 1 / 0;");
+    assert(countOperation(getCode(code), GobLang::Operation::DivInt) + countOperation(getCode(code), GobLang::Operation::Div) == 1);
+    bool thrown = false;
+    try
+    {
+        runCode(code, "r");
+    }
+    catch (GobLang::RuntimeException const &e)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void testConstantPropagation()
+{
+    ByteCode code = compileCode("let y = 5; r = y + 1;");
+    std::vector<Instruction> main = getCode(code);
+    assert(countOperation(main, GobLang::Operation::GetLocal) == 0);
+    assert(runCode(code, "r").value.integer == 6);
+    // variable is changed after being declared, so its first value can't be used in place of it
+    code = compileCode("let x = 5; x = 6; r = x + 1;");
+    main = getCode(code);
+    assert(countOperation(main, GobLang::Operation::GetLocal) == 1);
+    assert(runCode(code, "r").value.integer == 7);
+}
+
+void testShortCircuit()
+{
+    // right side must not be evaluated when left side already decides the result
+    ByteCode code = compileCode("let i = 5; let a = [1]; r = i < sizeof(a) && a[i] != 0;");
+    assert(runCode(code, "r").value.boolean == false);
+    code = compileCode("let i = 5; let a = [1]; r = i >= sizeof(a) || a[i] != 0;");
+    assert(runCode(code, "r").value.boolean == true);
+    code = compileCode("g = 0; func f(){ g = g + 1; return true; } c = false; r = c && f(); r = !c || f();");
+    assert(runCode(code, "g").value.integer == 0);
+    code = compileCode("g = 0; func f(){ g = g + 1; return true; } c = true; r = c && f(); r = !c || f();");
+    assert(runCode(code, "g").value.integer == 2);
+}
+
+void testShortCircuitInvalidRight()
+{
+    // right side decides the result, so it has to be a bool just like the left side
+    for (char const *line : {"t = true; r = t && 5;", "f = false; r = f || \"x\";", "r = true && 5;", "r = false || \"x\";"})
+    {
+        ByteCode code = compileCode(line);
+        assert(countOperation(getCode(code), GobLang::Operation::CheckBool) == 1);
+        bool thrown = false;
+        try
+        {
+            runCode(code, "r");
+        }
+        catch (GobLang::RuntimeException const &e)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    // comparison always produces a bool, so it doesn't need a separate check
+    ByteCode code = compileCode("x = 1; r = x < 2 && x != 0;");
+    assert(countOperation(getCode(code), GobLang::Operation::CheckBool) == 0);
+    assert(runCode(code, "r").value.boolean == true);
+}
+
+void testCompoundAssignmentOrder()
+{
+    // 'x op= e' must give the same result as 'x = x op e' even if 'e' changes 'x'
+    ByteCode code = compileCode("g = 1; func f(){ g = 10; return 1; } g += f();");
+    assert(countOperation(getCode(code), GobLang::Operation::OperateGlobal) == 0);
+    assert(runCode(code, "g").value.integer == 2);
+    code = compileCode("arr = [5]; func h(){ arr[0] = 100; return 1; } arr[0] += h(); r = arr[0];");
+    assert(countOperation(getCode(code), GobLang::Operation::OperateArray) == 0);
+    assert(runCode(code, "r").value.integer == 6);
+    // values that can't change the target still modify it in place
+    code = compileCode("g = 1; g += 2;");
+    assert(countOperation(getCode(code), GobLang::Operation::OperateGlobal) == 1);
+    assert(runCode(code, "g").value.integer == 3);
+    code = compileCode("arr = [5]; arr[0] += sizeof(arr); r = arr[0];");
+    assert(countOperation(getCode(code), GobLang::Operation::OperateArray) == 1);
+    assert(runCode(code, "r").value.integer == 6);
+}
+
+void testInline()
+{
+    // evaluation would replace calls with constant arguments before they can be inlined
+    ByteCode code = compileCode("func sq(x){ return x * x; } a = 7; r = sq(a);", {}, {"eval"});
+    std::vector<Instruction> main = getCode(code);
+    assert(countOperation(main, GobLang::Operation::CallLocal) == 0);
+    assert(code.functions.empty());
+    assert(runCode(code, "r").value.integer == 49);
+}
+
+void testInlineRecursive()
+{
+    ByteCode code = compileCode("func fact(n){ if(n < 2){ return 1; } return n * fact(n - 1); } a = 5; r = fact(a);", {}, {"eval"});
+    assert(countOperation(getCode(code), GobLang::Operation::CallLocal) == 1);
+    assert(code.functions.size() == 1);
+    assert(runCode(code, "r").value.integer == 120);
+}
+
+void testLoopInvariant()
+{
+    ByteCode code = compileCode("let d = [1, 2, 3, 4]; let i = 0; s = 0; while(i < sizeof(d)){ s = s + d[i]; i = i + 1; }");
+    std::vector<Instruction> main = getCode(code);
+    std::vector<size_t> calls = findNativeCalls(code, main, "sizeof");
+    assert(calls.size() == 1 && calls[0] < getLoopStart(main));
+    assert(runCode(code, "s").value.integer == 10);
+}
+
+void testLoopInvariantChanged()
+{
+    // size of the array changes inside of the loop, so it has to be checked on every iteration
+    ByteCode code = compileCode("let d = [1, 2]; let i = 0; while(i < sizeof(d) && i < 5){ append(d, i); i = i + 1; } s = sizeof(d);");
+    std::vector<Instruction> main = getCode(code);
+    std::vector<size_t> calls = findNativeCalls(code, main, "sizeof");
+    assert(calls.size() == 2 && calls[0] >= getLoopStart(main));
+    assert(runCode(code, "s").value.integer == 7);
+}
+
+void testCommonSubexpression()
+{
+    // second read of `p[0]` after the array is changed can't reuse the first one
+    std::string source = "let p = [3, 4]; r = p[0] * p[0] + p[1] * p[1]; let a = p[0] * 2; p[0] = 5; q = a + p[0];";
+    ByteCode plain = compileCode(source, {}, {"cse"});
+    ByteCode code = compileCode(source);
+    assert(countOperation(getCode(plain), GobLang::Operation::GetArrayLocal) == 6);
+    assert(countOperation(getCode(code), GobLang::Operation::GetArrayLocal) == 3);
+    assert(runCode(code, "r").value.integer == 25);
+    assert(runCode(code, "q").value.integer == 11);
+}
+
+void testBoundsCheck()
+{
+    ByteCode code = compileCode("let d = [1, 2, 3]; let i = 0; s = 0; while(i < sizeof(d)){ d[i] = d[i] * 2; s = s + d[i]; i = i + 1; }");
+    std::vector<Instruction> main = getCode(code);
+    assert(countOperation(main, GobLang::Operation::GetArrayLocal) == 0);
+    assert(countOperation(main, GobLang::Operation::GetArrayLocalUnchecked) > 0);
+    assert(countOperation(main, GobLang::Operation::SetArray) == 0);
+    assert(countOperation(main, GobLang::Operation::SetArrayUnchecked) == 1);
+    assert(runCode(code, "s").value.integer == 12);
+}
+
+void testBoundsCheckNegativeStart()
+{
+    // index is only negative if the branch is taken, but the check can't be removed for any path
+    ByteCode code = compileCode("k = 0; let d = [1, 2, 3]; let i = 0; if(k > 1){ i = -1; } s = 0; while(i < sizeof(d)){ s = s + d[i]; i = i + 1; }");
+    std::vector<Instruction> main = getCode(code);
+    assert(countOperation(main, GobLang::Operation::GetArrayLocal) == 1);
+    assert(countOperation(main, GobLang::Operation::GetArrayLocalUnchecked) == 0);
+    assert(runCode(code, "s").value.integer == 6);
+}
+
+void testBoundsCheckString()
+{
+    // type of the value is unknown during compilation, so strings use unchecked operations that fall back to checked access
+    ByteCode code = compileCode("let w = \"abcb\"; let i = 0; n = 0; while(i < sizeof(w)){ if(w[i] == 'b'){ n = n + 1; } i = i + 1; }");
+    std::vector<Instruction> main = getCode(code);
+    assert(countOperation(main, GobLang::Operation::GetArrayLocalUnchecked) == 1);
+    assert(runCode(code, "n").value.integer == 2);
+}
+
+void testBoundsCheckAppend()
+{
+    // array can grow inside of the loop, so the size from the condition doesn't limit the index
+    ByteCode code = compileCode("let d = [1, 2]; let i = 0; while(i < sizeof(d) && i < 5){ append(d, d[i]); i = i + 1; } s = sizeof(d);");
+    std::vector<Instruction> main = getCode(code);
+    assert(countOperation(main, GobLang::Operation::GetArrayLocal) == 1);
+    assert(countOperation(main, GobLang::Operation::GetArrayLocalUnchecked) == 0);
+    assert(runCode(code, "s").value.integer == 7);
+}
+
+/**
+ * @brief Get ids of functions called by the code in the order of calls
+ *
+ */
+std::vector<uint8_t> getCalledFunctions(std::vector<Instruction> const &code)
+{
+    std::vector<uint8_t> ids;
+    for (std::vector<Instruction>::const_iterator it = code.begin(); it != code.end(); it++)
+    {
+        if (it->op == GobLang::Operation::CallLocal || it->op == GobLang::Operation::TailCallLocal)
+        {
+            ids.push_back(it->args[0]);
+        }
+    }
+    return ids;
+}
+
+void testTailCall()
+{
+    // inlining and evaluation would remove the call before it reaches the runtime
+    ByteCode code = compileCode("func acc(n, s){ if(n == 0){ return s; } return acc(n - 1, s + 1); } r = acc(1000000, 0);",
+                                {}, {"eval", "inline"});
+    assert(countOperation(getCode(code, 0), GobLang::Operation::TailCallLocal) == 1);
+    assert(countOperation(getCode(code, 0), GobLang::Operation::CallLocal) == 0);
+    GobLang::Machine machine(code);
+    size_t maxDepth = 0;
+    while (!machine.isAtTheEnd())
+    {
+        machine.step();
+        maxDepth = std::max(maxDepth, machine.getCallDepth());
+    }
+    // main code and a single frame reused by every recursive call
+    assert(maxDepth == 2);
+    assert(machine.getVariableValue("r").value.integer == 1000000);
+}
+
+void testDeadFunctions()
+{
+    // unused function calls a function declared after it, which stays because it is also called from the main code
+    std::string source = "func unused(n){ return live(n) + 1; }"
+                         "func first(n){ if(n < 2){ return 1; } return n * first(n - 1); }"
+                         "func live(n){ if(n < 2){ return n; } return live(n - 1) + live(n - 2); }"
+                         "func down(n){ if(n < 1){ return 0; } return down(n - 1); }"
+                         "a = 6; r = live(a) + first(a); t = down(a);";
+    ByteCode plain = compileCode(source, {}, {"dce"});
+    assert(plain.functions.size() == 4);
+    assert(getCalledFunctions(getCode(plain)) == std::vector<uint8_t>({2, 1, 3}));
+
+    ByteCode code = compileCode(source);
+    assert(code.functions.size() == 3);
+    assert(getCalledFunctions(getCode(code)) == std::vector<uint8_t>({1, 0, 2}));
+    assert(getCalledFunctions(getCode(code, 0)) == std::vector<uint8_t>({0}));
+    assert(getCalledFunctions(getCode(code, 1)) == std::vector<uint8_t>({1, 1}));
+    std::vector<Instruction> down = getCode(code, 2);
+    assert(countOperation(down, GobLang::Operation::TailCallLocal) == 1);
+    assert(getCalledFunctions(down) == std::vector<uint8_t>({2}));
+    assert(runCode(code, "r").value.integer == 728);
+    assert(runCode(code, "t").value.integer == 0);
+}
+
+void testDeadBranches()
+{
+    ByteCode code = compileCode("r = 1; if(false){ r = 2; } while(false){ r = 3; } if(true){ r = r + 10; }");
+    std::vector<Instruction> main = getCode(code);
+    assert(countOperation(main, GobLang::Operation::JumpIfNot) == 0);
+    assert(countOperation(main, GobLang::Operation::PushFalse) == 0);
+    assert(runCode(code, "r").value.integer == 11);
+}
+
+void testBranchAtEnd()
+{
+    // branch that ends the main code must jump to its end, not to the end of the function generated after it
+    ByteCode code = compileCode("func f(){ return 1; } r = 2; c = false; if(c){ r = f(); }");
+    assert(runCode(code, "r").value.integer == 2);
+}
+
+void testEvaluation()
+{
+    ByteCode code = compileCode("func fib(n){ if(n <= 1){ return n; } return fib(n - 1) + fib(n - 2); } r = fib(20);");
+    std::vector<Instruction> main = getCode(code);
+    assert(countOperation(main, GobLang::Operation::CallLocal) == 0);
+    assert(main[0].op == GobLang::Operation::PushConstInt && main[0].args == parseToBytes((int32_t)6765));
+    assert(runCode(code, "r").value.integer == 6765);
+}
+
+void testEvaluationStepLimit()
+{
+    // calculating this value takes more operations than the evaluation is allowed to use
+    ByteCode code = compileCode("func fib(n){ if(n <= 1){ return n; } return fib(n - 1) + fib(n - 2); } r = fib(25);");
+    assert(countOperation(getCode(code), GobLang::Operation::CallLocal) == 1);
+    assert(runCode(code, "r").value.integer == 75025);
+    // function that never finishes is only compiled
+    code = compileCode("func forever(){ let i = 0; while(true){ i = i + 1; } return i; } r = forever();", {}, {"inline"});
+    assert(countOperation(getCode(code), GobLang::Operation::CallLocal) == 1);
+}
+
+void testEvaluationTotalLimit()
+{
+    // each call uses its whole limit, so calls evaluated after them have nothing left
+    std::string spins = "s1 = spin(1); s2 = spin(2); s3 = spin(3); s4 = spin(4); s5 = spin(5);";
+    std::string funcs = "func sq(x){ return x * x; } func spin(n){ while(true){ n = n + 1; } return n; }";
+    ByteCode code = compileCode(funcs + "r = sq(3);" + spins, {}, {"inline"});
+    assert(countOperation(getCode(code), GobLang::Operation::CallLocal) == 6);
+    // code that never runs is removed before any call is evaluated
+    code = compileCode(funcs + "r = sq(3); if(false){" + spins + "}", {}, {"inline"});
+    assert(countOperation(getCode(code), GobLang::Operation::CallLocal) == 0);
+    assert(runCode(code, "r").value.integer == 9);
+}
+
+void testEvaluationError()
+{
+    ByteCode code = compileCode("func at(i){ let arr = [1, 2]; return arr[i]; } r = at(5);", {}, {"inline"});
+    assert(countOperation(getCode(code), GobLang::Operation::CallLocal) == 1);
+    bool thrown = false;
+    try
+    {
+        runCode(code, "r");
+    }
+    catch (GobLang::RuntimeException const &e)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void testEvaluationImpure()
+{
+    // functions that read globals or call native functions depend on more than their arguments
+    ByteCode code = compileCode("g = 3; func withGlobal(x){ return g + x; } r = withGlobal(1);", {}, {"inline"});
+    assert(countOperation(getCode(code), GobLang::Operation::CallLocal) == 1);
+    assert(runCode(code, "r").value.integer == 4);
+    code = compileCode("func withNative(x){ return sizeof([1, 2, x]); } r = withNative(3);", {}, {"inline"});
+    assert(countOperation(getCode(code), GobLang::Operation::CallLocal) == 1);
+    assert(runCode(code, "r").value.integer == 3);
+}
+
+void testEvaluationDivision()
+{
+    // invalid division during evaluation must not crash the compiler, the error is left for the runtime instead
+    ByteCode code = compileCode("func f(a, b){ return a / b; } func g(a, b){ return a % b; }"
+                                "c = 1; if(c == 2){ r = f(1, 0); } if(c == 2){ r = g(-2147483647 - 1, -1); } r = 5;");
+    assert(runCode(code, "r").value.integer == 5);
+    bool thrown = false;
+    try
+    {
+        runCode(compileCode("func f(a, b){ return a / b; } r = f(1, 0);"), "r");
+    }
+    catch (GobLang::RuntimeException const &e)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void testInvalidOperation()
+{
+    ByteCode code;
+    code.operations = {(uint8_t)GobLang::Operation::PushNull, 200};
+    bool thrown = false;
+    try
+    {
+        runCode(code, "r");
+    }
+    catch (GobLang::RuntimeException const &e)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void testCollectCycle()
+{
+    // arrays reference each other, so they are only freed by tracing from the roots
+    GobLang::Machine machine(compileCode("a = [0]; b = [a]; a[0] = b; a = null; b = null;"));
+    while (!machine.isAtTheEnd())
+    {
+        machine.run();
+    }
+    size_t count = machine.getObjectCount();
+    assert(count >= 2);
+    machine.collect();
+    assert(machine.getObjectCount() == count - 2);
+}
+
+void testCollectInLoop()
+{
+    // loop only calls functions and increases the counter, without storing values anywhere
+    GobLang::Machine machine(compileCode("let i = 0; while(i < 100000){ sizeof(str(i)); i = i + 1; }"));
+    MachineFunctions::bind(&machine);
+    while (!machine.isAtTheEnd())
+    {
+        machine.run();
+    }
+    assert(machine.getObjectCount() < 10000);
+}
+
 int main(int, char **)
 {
     testArray();
@@ -193,5 +741,35 @@ int main(int, char **)
     testFunctionArgs2();
     testArrayCreation();
     testArrayCreationNest();
+    testInvalidOperation();
+    testGlobalLimit();
+    testCollectCycle();
+    testCollectInLoop();
+    testNativeLimit();
+    testConstantFolding();
+    testConstantFoldingDivision();
+    testConstantPropagation();
+    testShortCircuit();
+    testShortCircuitInvalidRight();
+    testCompoundAssignmentOrder();
+    testInline();
+    testInlineRecursive();
+    testLoopInvariant();
+    testLoopInvariantChanged();
+    testCommonSubexpression();
+    testBoundsCheck();
+    testBoundsCheckNegativeStart();
+    testBoundsCheckString();
+    testBoundsCheckAppend();
+    testTailCall();
+    testDeadFunctions();
+    testDeadBranches();
+    testBranchAtEnd();
+    testEvaluation();
+    testEvaluationStepLimit();
+    testEvaluationTotalLimit();
+    testEvaluationError();
+    testEvaluationImpure();
+    testEvaluationDivision();
     return EXIT_SUCCESS;
 }
\ No newline at end of file